@@ -0,0 +1,91 @@
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "sequential.hpp"
+#include "view.hpp"
+#include "arena.hpp"
+
+
+namespace
+{
+    // a syntax tree node per entry, linked into a list
+    struct entry_node
+    {
+        int value;
+        entry_node* next;
+    };
+
+    struct owning_entry_node
+    {
+        int value;
+        std::unique_ptr<owning_entry_node> next;
+    };
+}
+
+
+// Reads sequential data into a list of nodes and into a vector, allocated from the heap and from
+// an arena reused for every run.
+int main()
+{
+    const auto data = benchmark::sequential_data(1000000);
+
+    benchmark::report("nodes, new", benchmark::measure([&]() {
+        std::string_view ins = data;
+        whirl::code_position pos{ 1, 1 };
+        std::unique_ptr<owning_entry_node> head;
+        auto tail = &head;
+
+        for (const auto value : whirl::parse_view(ins, pos, sequential::read_data_entry))
+        {
+            *tail = std::make_unique<owning_entry_node>(owning_entry_node{ value, nullptr });
+            tail = &(*tail)->next;
+        }
+
+        benchmark::keep(head->value);
+
+        // a long list would overflow the stack when destroyed recursively
+        while (head)
+            head = std::move(head->next);
+    }), data.size());
+
+    whirl::arena arena;
+
+    benchmark::report("nodes, arena", benchmark::measure([&]() {
+        std::string_view ins = data;
+        whirl::code_position pos{ 1, 1 };
+        entry_node* head = nullptr;
+        auto tail = &head;
+
+        for (const auto value : whirl::parse_view(ins, pos, sequential::read_data_entry))
+        {
+            *tail = arena.make<entry_node>(entry_node{ value, nullptr });
+            tail = &(*tail)->next;
+        }
+
+        benchmark::keep(head->value);
+        arena.reset();
+    }), data.size());
+
+    benchmark::report("vector, heap", benchmark::measure([&]() {
+        std::string_view ins = data;
+        whirl::code_position pos{ 1, 1 };
+
+        const auto values = sequential::read_data_entries(ins, pos);
+
+        benchmark::keep(values.size());
+    }), data.size());
+
+    benchmark::report("vector, arena", benchmark::measure([&]() {
+        std::string_view ins = data;
+        whirl::code_position pos{ 1, 1 };
+
+        whirl::arena_vector<int> values{ &arena };
+
+        sequential::read_data_entries(ins, pos, std::back_inserter(values));
+
+        benchmark::keep(values.size());
+        arena.reset();
+    }), data.size());
+}
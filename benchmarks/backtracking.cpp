@@ -0,0 +1,120 @@
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include "benchmark.hpp"
+#include "sequential.hpp"
+#include "backtracking.hpp"
+
+
+namespace
+{
+    // Whitespace separated whole numbers, of which every given share is a time like 12:30.
+    std::string mixed_data(std::size_t count, std::size_t time_share, std::uint32_t seed = 42)
+    {
+        std::string data;
+
+        for (std::size_t idx = 0; idx < count; ++idx)
+        {
+            seed = seed * 1664525u + 1013904223u;
+
+            const auto value = static_cast<int>(seed >> 20) % 1000;
+
+            if (time_share > 0 && idx % time_share == 0)
+                data += std::to_string(value % 24) + ":" + std::to_string(10 + value % 50);
+            else
+                data += std::to_string(value - 500);
+
+            data += ' ';
+        }
+
+        return data;
+    }
+
+    constexpr auto read_time = [](auto& ins, whirl::code_position& pos) {
+        const auto hours = sequential::read_data_entry(ins, pos);
+
+        whirl::next_is(ins, pos, whirl::is(':'));
+
+        return hours * 60 + sequential::read_data_entry(ins, pos);
+    };
+
+    template <typename I>
+    long long sum_values(I& ins)
+    {
+        whirl::code_position pos{ 1, 1 };
+        long long sum = 0;
+
+        for (whirl::next_while(ins, pos, whirl::space); !whirl::is(ins, whirl::end);
+            whirl::next_while(ins, pos, whirl::space))
+        {
+            if (const auto minutes = whirl::attempt(ins, pos, read_time))
+                sum += *minutes;
+            else
+                sum += sequential::read_data_entry(ins, pos);
+        }
+
+        return sum;
+    }
+
+    // backtracking with the stream's own positioning
+    long long sum_values_seeking(std::istream& ins)
+    {
+        whirl::code_position pos{ 1, 1 };
+        long long sum = 0;
+
+        for (whirl::next_while(ins, pos, whirl::space); !whirl::is(ins, whirl::end);
+            whirl::next_while(ins, pos, whirl::space))
+        {
+            const auto mark = ins.tellg();
+            const auto start_pos = pos;
+
+            try
+            {
+                sum += read_time(ins, pos);
+            }
+            catch (const whirl::unexpected_input&)
+            {
+                ins.clear();
+                ins.seekg(mark);
+                pos = start_pos;
+
+                sum += sequential::read_data_entry(ins, pos);
+            }
+        }
+
+        return sum;
+    }
+}
+
+
+// Reads numbers and times, trying to read a time first. The share of failing attempts determines
+// the cost, which is compared to seeking in a stream.
+int main()
+{
+    for (const std::size_t time_share : { 1, 2, 16 })
+    {
+        const auto data = mixed_data(200000, time_share);
+        const auto suffix = ", 1/" + std::to_string(time_share) + " times";
+
+        benchmark::report("attempt, string_view" + suffix, benchmark::measure([&]() {
+            std::string_view ins = data;
+
+            benchmark::keep(sum_values(ins));
+        }), data.size());
+
+        benchmark::report("attempt, replay_source" + suffix, benchmark::measure([&]() {
+            std::istringstream iss(data);
+            whirl::replay_source ins(iss);
+
+            benchmark::keep(sum_values(ins));
+        }), data.size());
+
+        benchmark::report("seekg, istringstream" + suffix, benchmark::measure([&]() {
+            std::istringstream iss(data);
+
+            benchmark::keep(sum_values_seeking(iss));
+        }), data.size());
+    }
+}
@@ -0,0 +1,100 @@
+#ifndef __BENCHMARK_HPP__
+#define __BENCHMARK_HPP__
+
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "allocation_counter.hpp"
+
+
+namespace benchmark
+{
+
+    // the heap allocations of the last run measured
+    inline allocations::statistics& last_allocations() noexcept
+    {
+        static allocations::statistics statistics{ 0, 0 };
+
+        return statistics;
+    }
+
+    // Returns the best of several runs in seconds.
+    template <typename F>
+    double measure(F&& func, int repetitions = 5)
+    {
+        auto best = std::chrono::duration<double>::max();
+
+        for (int run = 0; run < repetitions; ++run)
+        {
+            const allocations::counter counter;
+            const auto start = std::chrono::steady_clock::now();
+
+            func();
+
+            best = std::min<std::chrono::duration<double>>(
+                best, std::chrono::steady_clock::now() - start);
+
+            last_allocations() = counter.get();
+        }
+
+        return best.count();
+    }
+
+    // Reports the time of a run, the throughput and the allocations of the last run.
+    inline void report(const std::string& name, double seconds, std::size_t bytes)
+    {
+        const auto allocated = last_allocations();
+
+        std::cout << std::left << std::setw(40) << name
+                  << std::right << std::setw(10) << std::fixed << std::setprecision(2)
+                  << seconds * 1000.0 << " ms"
+                  << std::setw(10) << std::fixed << std::setprecision(1)
+                  << bytes / seconds / (1024.0 * 1024.0) << " MiB/s"
+                  << std::setw(10) << allocated.count << " allocs"
+                  << std::setw(12) << allocated.bytes << " bytes\n";
+    }
+
+    // Whitespace separated whole numbers as read by the sequential example.
+    inline std::string sequential_data(std::size_t count, std::uint32_t seed = 42)
+    {
+        std::string data;
+
+        data.reserve(count * 5);
+
+        for (std::size_t idx = 0; idx < count; ++idx)
+        {
+            seed = seed * 1664525u + 1013904223u;
+
+            const auto value = static_cast<int>(seed >> 20) % 2000 - 1000;
+
+            data += std::to_string(value);
+            data += (idx % 16 == 15) ? '\n' : ' ';
+        }
+
+        return data;
+    }
+
+    // Keeps the compiler from optimizing away a benchmarked result. The empty assembly claims to
+    // read the value from memory.
+    template <typename T>
+    void keep(const T& value)
+    {
+    #if defined(__GNUC__)
+        asm volatile("" : : "m"(value) : "memory");
+    #else
+        static volatile auto sink = T{ };
+
+        sink = value;
+        static_cast<void>(sink);
+    #endif
+    }
+
+}
+
+
+#endif /*__BENCHMARK_HPP__*/
@@ -0,0 +1,97 @@
+#include <string>
+#include <string_view>
+
+#include "benchmark.hpp"
+#include "delimiter.hpp"
+
+
+namespace
+{
+    // Comma separated records of a timestamp, a sensor name and a value, ended by CR LF.
+    std::string record_data(std::size_t count)
+    {
+        std::string data;
+
+        for (std::size_t idx = 0; idx < count; ++idx)
+        {
+            data += "2024-01-01T00:00:00Z,temperature sensor ";
+            data += std::to_string(idx % 100);
+            data += ",23.45\r\n";
+        }
+
+        return data;
+    }
+
+    template <typename F>
+    std::size_t count_fields(std::string_view ins, F read_field)
+    {
+        std::size_t count = 0;
+
+        while (!ins.empty())
+        {
+            read_field(ins);
+            ins.remove_prefix(ins.empty() ? 0 : 1);
+            ++count;
+        }
+
+        return count;
+    }
+}
+
+
+// Reads the fields of comma separated records per character, with a code unit class and by
+// delimiter search.
+int main()
+{
+    const auto records = record_data(300000);
+
+    benchmark::report("fields, next_while_view", benchmark::measure([&]() {
+        benchmark::keep(count_fields(records, [](std::string_view& ins) {
+            return whirl::next_while_view(ins, whirl::is_none_of(',', '\n'));
+        }));
+    }), records.size());
+
+    const whirl::code_unit_class field_class{ whirl::is_none_of(',', '\n') };
+
+    benchmark::report("fields, code unit class", benchmark::measure([&]() {
+        benchmark::keep(count_fields(records, [&](std::string_view& ins) {
+            return whirl::next_while_view(ins, field_class);
+        }));
+    }), records.size());
+
+    benchmark::report("fields, next_until_one_of", benchmark::measure([&]() {
+        benchmark::keep(count_fields(records, [](std::string_view& ins) {
+            return whirl::next_until_one_of(ins, ',', '\n');
+        }));
+    }), records.size());
+
+    benchmark::report("lines, next_while_view", benchmark::measure([&]() {
+        benchmark::keep(count_fields(records, [](std::string_view& ins) {
+            return whirl::next_while_view(ins, whirl::is_not('\n'));
+        }));
+    }), records.size());
+
+    benchmark::report("lines, next_until", benchmark::measure([&]() {
+        benchmark::keep(count_fields(records, [](std::string_view& ins) {
+            return whirl::next_until(ins, '\n');
+        }));
+    }), records.size());
+
+    benchmark::report("CR LF lines, std::string_view::find", benchmark::measure([&]() {
+        benchmark::keep(count_fields(records, [](std::string_view& ins) {
+            const auto count = std::min(ins.find("\r\n"), ins.size());
+
+            ins.remove_prefix(count);
+            ins.remove_prefix(ins.empty() ? 0 : 1);
+        }));
+    }), records.size());
+
+    benchmark::report("CR LF lines, next_until", benchmark::measure([&]() {
+        using namespace std::literals;
+
+        benchmark::keep(count_fields(records, [](std::string_view& ins) {
+            whirl::next_until(ins, "\r\n"sv);
+            ins.remove_prefix(ins.empty() ? 0 : 1);
+        }));
+    }), records.size());
+}
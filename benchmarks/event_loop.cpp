@@ -0,0 +1,98 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <exception>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "benchmark.hpp"
+#include "sequential.hpp"
+#include "event_loop.hpp"
+
+#if defined(WHIRL_HAS_EPOLL)
+    #include <sys/socket.h>
+    #include <unistd.h>
+#endif
+
+
+#if defined(WHIRL_HAS_EPOLL)
+
+namespace
+{
+    // Parses the data sent over every one of the given number of local sockets on one thread. The
+    // data is sent by a peer thread in 4 KiB fragments, interleaving all connections.
+    void parse_connections(const std::string& data, std::size_t connection_count)
+    {
+        constexpr std::size_t fragment_size = 4096;
+
+        whirl::event_loop loop;
+        std::vector<int> peers;
+        std::size_t entry_count = 0;
+
+        for (std::size_t idx = 0; idx < connection_count; ++idx)
+        {
+            int pair[2];
+
+            if (::socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0)
+                throw std::system_error{ errno, std::generic_category(), "socketpair" };
+
+            peers.push_back(pair[1]);
+
+            loop.watch(
+                pair[0],
+                whirl::resumable_parser{ sequential::read_data_entry },
+                [&entry_count](int) { ++entry_count; },
+                [](const auto&, std::exception_ptr error) {
+                    if (error)
+                        std::rethrow_exception(error);
+                });
+        }
+
+        std::thread peer([&]() {
+            for (std::size_t offset = 0; offset < data.size(); offset += fragment_size)
+            {
+                const auto count = std::min(fragment_size, data.size() - offset);
+
+                for (const auto fd : peers)
+                    ::send(fd, data.data() + offset, count, MSG_NOSIGNAL);
+            }
+
+            for (const auto fd : peers)
+                ::close(fd);
+        });
+
+        loop.run();
+        peer.join();
+
+        benchmark::keep(entry_count);
+    }
+}
+
+
+// Parses about 5 MB sent over an increasing number of connections, which are all served by a
+// single thread.
+int main()
+{
+    constexpr std::size_t total_count = 1000000;
+
+    for (const std::size_t connection_count : { 1, 16, 256, 1024, 4096 })
+    {
+        const auto data = benchmark::sequential_data(total_count / connection_count);
+
+        benchmark::report(
+            std::to_string(connection_count) + " connections per thread",
+            benchmark::measure([&]() { parse_connections(data, connection_count); }, 3),
+            data.size() * connection_count);
+    }
+}
+
+#else
+
+int main()
+{
+    std::cout << "event loops aren't available on this platform\n";
+}
+
+#endif
@@ -0,0 +1,82 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+
+#include "benchmark.hpp"
+#include "fixed_point.hpp"
+
+
+namespace
+{
+    // Numbers with the given number of decimals, separated by spaces.
+    std::string decimal_data(std::size_t count, int decimals)
+    {
+        std::string data;
+
+        for (std::size_t idx = 0; idx < count; ++idx)
+        {
+            char number[32];
+
+            const auto value = static_cast<double>(idx * 7919 % 100000) / 1000 - 50;
+
+            std::snprintf(number, sizeof number, "%.*f ", decimals, value);
+            data += number;
+        }
+
+        return data;
+    }
+
+    // parsing a double and scaling it, the string has to be null terminated
+    template <long long Scale>
+    long long read_double(std::string_view& ins)
+    {
+        char* end = nullptr;
+
+        const auto value = std::strtod(ins.data(), &end);
+
+        ins.remove_prefix(static_cast<std::size_t>(end - ins.data()));
+
+        return std::llround(value * Scale);
+    }
+
+    template <typename F>
+    long long read_all(std::string_view ins, F read_number)
+    {
+        long long sum = 0;
+
+        while (!ins.empty())
+        {
+            sum += read_number(ins);
+            whirl::next(ins);
+        }
+
+        return sum;
+    }
+}
+
+
+// Reads decimal numbers as scaled integers by parsing doubles and with read_fixed_point, for short
+// and long fractions.
+int main()
+{
+    const auto temperatures = decimal_data(500000, 2);
+    const auto coordinates = decimal_data(500000, 6);
+
+    benchmark::report("temperatures, strtod and scaling", benchmark::measure([&]() {
+        benchmark::keep(read_all(temperatures, read_double<100>));
+    }), temperatures.size());
+
+    benchmark::report("temperatures, read_fixed_point", benchmark::measure([&]() {
+        benchmark::keep(read_all(temperatures, whirl::read_fixed_point<long long, 100>()));
+    }), temperatures.size());
+
+    benchmark::report("coordinates, strtod and scaling", benchmark::measure([&]() {
+        benchmark::keep(read_all(coordinates, read_double<1000000>));
+    }), coordinates.size());
+
+    benchmark::report("coordinates, read_fixed_point", benchmark::measure([&]() {
+        benchmark::keep(read_all(coordinates, whirl::read_fixed_point<long long, 1000000>()));
+    }), coordinates.size());
+}
@@ -0,0 +1,100 @@
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+#include "benchmark.hpp"
+#include "delimiter.hpp"
+#include "iso8601.hpp"
+
+
+namespace
+{
+    // Measurement records starting with a timestamp, every other one with milliseconds.
+    std::string record_data(std::size_t count)
+    {
+        std::string data;
+
+        for (std::size_t idx = 0; idx < count; ++idx)
+        {
+            char record[64];
+
+            std::snprintf(record, sizeof record, "2024-%02zu-%02zuT%02zu:%02zu:%02zu%sZ 23.45\n",
+                idx % 12 + 1, idx % 28 + 1, idx % 24, idx % 60, idx * 7 % 60,
+                idx % 2 ? ".125" : "");
+
+            data += record;
+        }
+
+        return data;
+    }
+
+    // a timestamp read with the basic primitives, checking every character against a predicate
+    whirl::iso8601_time read_per_character(std::string_view& ins)
+    {
+        const auto read_number = [&ins](int digits) {
+            int value = 0;
+
+            for (; digits > 0; --digits)
+                value = value * 10 + (whirl::next_is(ins, whirl::digit, whirl::as_is) - '0');
+
+            return value;
+        };
+
+        whirl::detail::iso8601_fields fields;
+
+        fields.year = read_number(4);
+        whirl::next_is(ins, whirl::is('-'));
+        fields.month = read_number(2);
+        whirl::next_is(ins, whirl::is('-'));
+        fields.day = read_number(2);
+        whirl::next_is(ins, whirl::is('T'));
+        fields.hour = read_number(2);
+        whirl::next_is(ins, whirl::is(':'));
+        fields.minute = read_number(2);
+        whirl::next_is(ins, whirl::is(':'));
+        fields.second = read_number(2);
+
+        if (whirl::is(ins, '.'))
+        {
+            whirl::next(ins);
+
+            for (std::int64_t scale = 100000000; whirl::is(ins, whirl::digit); scale /= 10)
+                fields.nanoseconds += scale * (whirl::next(ins, whirl::as_is) - '0');
+        }
+
+        whirl::next_is(ins, whirl::is('Z'));
+
+        return whirl::detail::to_time_point(fields);
+    }
+
+    template <typename F>
+    std::uint64_t read_all(std::string_view ins, F read_time)
+    {
+        std::uint64_t sum = 0;
+
+        while (!ins.empty())
+        {
+            sum += static_cast<std::uint64_t>(read_time(ins).time_since_epoch().count());
+            whirl::next_until(ins, '\n');
+            whirl::next(ins);
+        }
+
+        return sum;
+    }
+}
+
+
+// Reads the timestamps of records character by character with predicates and with read_iso8601.
+int main()
+{
+    const auto records = record_data(500000);
+
+    benchmark::report("per character", benchmark::measure([&]() {
+        benchmark::keep(read_all(records, read_per_character));
+    }), records.size());
+
+    benchmark::report("read_iso8601", benchmark::measure([&]() {
+        benchmark::keep(read_all(records, whirl::read_iso8601()));
+    }), records.size());
+}
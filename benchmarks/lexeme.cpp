@@ -0,0 +1,74 @@
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "benchmark.hpp"
+#include "lexeme.hpp"
+
+
+namespace
+{
+    // Space separated words of 1 to 24 characters.
+    std::string word_data(std::size_t count, std::uint32_t seed = 42)
+    {
+        std::string data;
+
+        for (std::size_t idx = 0; idx < count; ++idx)
+        {
+            seed = seed * 1664525u + 1013904223u;
+
+            data.append(1 + (seed >> 24) % 24, static_cast<char>('a' + (seed >> 16) % 26));
+            data += ' ';
+        }
+
+        return data;
+    }
+
+    template <typename F>
+    std::size_t read_words(const std::string& data, F read_word)
+    {
+        std::string_view ins = data;
+        std::size_t length = 0;
+
+        while (!whirl::is(ins, whirl::end))
+        {
+            length += read_word(ins);
+            whirl::next_while(ins, whirl::space);
+        }
+
+        return length;
+    }
+}
+
+
+// Reads words into strings character by character, and as views with a predicate and with a code
+// unit class.
+int main()
+{
+    const auto data = word_data(500000);
+    const auto word_char = whirl::is_none_of(' ', '\t', '\n');
+    const whirl::code_unit_class word_class{ word_char };
+
+    benchmark::report("std::string per character", benchmark::measure([&]() {
+        benchmark::keep(read_words(data, [&](std::string_view& ins) {
+            std::string word;
+
+            while (!whirl::is(ins, whirl::end) && word_char.is(ins))
+                word.push_back(whirl::input_source_traits<std::string_view>::read(ins));
+
+            return word.size();
+        }));
+    }), data.size());
+
+    benchmark::report("next_while_view, predicate", benchmark::measure([&]() {
+        benchmark::keep(read_words(data, [&](std::string_view& ins) {
+            return whirl::next_while_view(ins, word_char).size();
+        }));
+    }), data.size());
+
+    benchmark::report("next_while_view, code unit class", benchmark::measure([&]() {
+        benchmark::keep(read_words(data, [&](std::string_view& ins) {
+            return whirl::next_while_view(ins, word_class).size();
+        }));
+    }), data.size());
+}
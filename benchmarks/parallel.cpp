@@ -0,0 +1,41 @@
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+#include "benchmark.hpp"
+#include "sequential.hpp"
+#include "parallel.hpp"
+
+
+// Reads sequential data on thread pools of 1 to N threads. N defaults to the number of hardware
+// threads and can be given as first argument.
+int main(int argc, char** argv)
+{
+    const auto max_threads = argc > 1 ?
+        static_cast<std::size_t>(std::atoi(argv[1])) :
+        static_cast<std::size_t>(std::max(std::thread::hardware_concurrency(), 1u));
+
+    const auto data = benchmark::sequential_data(10000000);
+
+    benchmark::report("read_data_entries (string_view)", benchmark::measure([&]() {
+        std::string_view ins = data;
+        whirl::code_position pos{ 1, 1 };
+
+        benchmark::keep(sequential::read_data_entries(ins, pos).size());
+    }, 3), data.size());
+
+    for (std::size_t threads = 1; threads <= max_threads; threads = threads < max_threads ?
+        std::min(2 * threads, max_threads) : threads + 1)
+    {
+        whirl::thread_pool pool(threads);
+
+        benchmark::report(
+            "read_data_entries_parallel (" + std::to_string(threads) + " threads)",
+            benchmark::measure([&]() {
+                whirl::code_position pos{ 1, 1 };
+
+                benchmark::keep(sequential::read_data_entries_parallel(data, pos, pool).size());
+            }, 3),
+            data.size());
+    }
+}
@@ -0,0 +1,75 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include "benchmark.hpp"
+#include "sequential.hpp"
+#include "pipeline.hpp"
+
+
+namespace
+{
+    // Stands in for a slow source like a pipe or a socket, which delivers chunks with a latency.
+    class slow_source
+    {
+
+    public:
+
+        slow_source(const std::string& data, std::chrono::microseconds latency)
+            : m_data{ data }
+            , m_latency{ latency }
+        { }
+
+        std::size_t operator()(char* buffer, std::size_t capacity)
+        {
+            const auto count = std::min(capacity, m_data.size() - m_pos);
+
+            std::this_thread::sleep_for(m_latency);
+            std::memcpy(buffer, m_data.data() + m_pos, count);
+
+            m_pos += count;
+
+            return count;
+        }
+
+    private:
+
+        const std::string& m_data;
+        std::chrono::microseconds m_latency;
+        std::size_t m_pos = 0;
+
+    };
+}
+
+
+// Reads sequential data from a source with a latency of 200 us per 64 KiB chunk, once by reading
+// all chunks before parsing and once overlapped by a pipelined source.
+int main()
+{
+    const auto data = benchmark::sequential_data(1000000);
+    const auto latency = std::chrono::microseconds{ 200 };
+    const auto chunk_size = whirl::pipelined_source<char>::default_chunk_size;
+
+    benchmark::report("read, then parse", benchmark::measure([&]() {
+        slow_source source(data, latency);
+        std::string buffer;
+        std::string chunk(chunk_size, '\0');
+
+        while (const auto count = source(chunk.data(), chunk.size()))
+            buffer.append(chunk.data(), count);
+
+        std::string_view ins = buffer;
+        whirl::code_position pos{ 1, 1 };
+
+        benchmark::keep(sequential::read_data_entries(ins, pos).size());
+    }, 3), data.size());
+
+    benchmark::report("pipelined_source", benchmark::measure([&]() {
+        whirl::pipelined_source<char> ins(slow_source(data, latency));
+        whirl::code_position pos{ 1, 1 };
+
+        benchmark::keep(sequential::read_data_entries(ins, pos).size());
+    }, 3), data.size());
+}
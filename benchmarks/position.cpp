@@ -0,0 +1,85 @@
+#include <string>
+#include <string_view>
+
+#include "benchmark.hpp"
+#include "whirl.hpp"
+
+
+namespace
+{
+    // Lines of words separated by spaces.
+    std::string line_data(std::size_t count)
+    {
+        std::string data;
+
+        for (std::size_t idx = 0; idx < count; ++idx)
+            data += idx % 8 == 7 ? "measurement\n" : "measurement ";
+
+        return data;
+    }
+
+    template <typename P>
+    std::uint64_t scan_per_character(std::string_view ins, const P& pred)
+    {
+        whirl::code_position pos{ 1, 1 };
+
+        while (!whirl::is(ins, whirl::end))
+        {
+            while (pred.is(ins))
+                whirl::next(ins, pos);
+
+            whirl::next(ins, pos);
+        }
+
+        return pos.row + pos.col;
+    }
+
+    template <typename P>
+    std::uint64_t scan_in_bulk(std::string_view ins, const P& pred)
+    {
+        whirl::code_position pos{ 1, 1 };
+
+        while (!whirl::is(ins, whirl::end))
+        {
+            whirl::next_while(ins, pos, pred);
+            whirl::next(ins, pos);
+        }
+
+        return pos.row + pos.col;
+    }
+}
+
+
+// Updates code positions for every character and once per run, e.g. for a whole buffer after
+// parsing it in parallel, or for every word consumed by next_while.
+int main()
+{
+    const auto text = line_data(1000000);
+
+    benchmark::report("buffer, update per character", benchmark::measure([&]() {
+        whirl::code_position pos{ 1, 1 };
+
+        for (const auto chr : text)
+            pos.update(chr);
+
+        benchmark::keep(pos.row + pos.col);
+    }), text.size());
+
+    benchmark::report("buffer, advance", benchmark::measure([&]() {
+        whirl::code_position pos{ 1, 1 };
+
+        pos.advance(std::string_view{ text });
+
+        benchmark::keep(pos.row + pos.col);
+    }), text.size());
+
+    const auto word_char = whirl::is_none_of(' ', '\n');
+
+    benchmark::report("words, update per character", benchmark::measure([&]() {
+        benchmark::keep(scan_per_character(text, word_char));
+    }), text.size());
+
+    benchmark::report("words, next_while", benchmark::measure([&]() {
+        benchmark::keep(scan_in_bulk(text, word_char));
+    }), text.size());
+}
@@ -0,0 +1,91 @@
+#include <string>
+#include <string_view>
+
+#include "benchmark.hpp"
+#include "arena.hpp"
+#include "quoted.hpp"
+
+
+namespace
+{
+    // Quoted names separated by spaces, of which every eighth one contains an escaped quote.
+    std::string quoted_data(std::size_t count)
+    {
+        std::string data;
+
+        for (std::size_t idx = 0; idx < count; ++idx)
+        {
+            data += idx % 8 == 0
+                ? "\"outdoor \\\"north\\\" temperature\" "
+                : "\"outdoor temperature sensor north\" ";
+        }
+
+        return data;
+    }
+
+    // a quoted string read with the basic primitives, one character at a time
+    std::string read_per_character(std::string_view& ins)
+    {
+        std::string result;
+
+        whirl::next_is(ins, whirl::is('"'));
+
+        while (!whirl::is(ins, '"'))
+        {
+            if (whirl::is(ins, '\\'))
+                whirl::next(ins);
+
+            result += whirl::next(ins, whirl::as_is);
+        }
+
+        whirl::next(ins);
+
+        return result;
+    }
+
+    template <typename F>
+    std::size_t read_all(std::string_view ins, F read_string)
+    {
+        std::size_t size = 0;
+
+        while (!ins.empty())
+        {
+            size += read_string(ins).size();
+            whirl::next_while(ins, whirl::space);
+        }
+
+        return size;
+    }
+}
+
+
+// Reads quoted strings character by character, and with read_quoted into a reused string and
+// into an arena.
+int main()
+{
+    const auto strings = quoted_data(300000);
+
+    benchmark::report("per character", benchmark::measure([&]() {
+        benchmark::keep(read_all(strings, read_per_character));
+    }), strings.size());
+
+    benchmark::report("read_quoted, string buffer", benchmark::measure([&]() {
+        std::string buffer;
+
+        benchmark::keep(read_all(strings, [&](std::string_view& ins) {
+            return whirl::read_quoted(ins, buffer);
+        }));
+    }), strings.size());
+
+    whirl::arena arena;
+
+    benchmark::report("read_quoted, arena buffer", benchmark::measure([&]() {
+        arena.reset();
+
+        whirl::arena_string buffer{ &arena };
+
+        benchmark::keep(read_all(strings, [&](std::string_view& ins) {
+            return whirl::read_quoted(ins, buffer);
+        }));
+    }), strings.size());
+}
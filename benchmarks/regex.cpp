@@ -0,0 +1,81 @@
+#include <cstddef>
+#include <cstdlib>
+#include <iterator>
+#include <regex>
+#include <sstream>
+#include <string_view>
+
+#include "benchmark.hpp"
+#include "whirl.hpp"
+#include "regex.hpp"
+
+
+// Counts the whole numbers of sequential data with std::regex, with a compiled whirl regex and with
+// hand-written whirl predicates.
+int main()
+{
+    const auto data = benchmark::sequential_data(1000000);
+
+    constexpr auto number = whirl::regex("-?(0|[1-9][0-9]*)");
+
+    constexpr auto read_sign = whirl::next_is(whirl::negative_sign);
+    constexpr auto read_digits = whirl::next_while(whirl::digit);
+
+    benchmark::report("std::regex", benchmark::measure([&]() {
+        const std::regex pattern("-?(0|[1-9][0-9]*)");
+
+        benchmark::keep(std::distance(
+            std::sregex_iterator(data.begin(), data.end(), pattern), std::sregex_iterator()));
+    }, 1), data.size());
+
+    benchmark::report("whirl::regex (string_view)", benchmark::measure([&]() {
+        std::string_view ins = data;
+        std::size_t count = 0;
+
+        for (whirl::next_while(ins, whirl::space); !ins.empty(); ++count)
+        {
+            number(ins);
+            whirl::next_while(ins, whirl::space);
+        }
+
+        benchmark::keep(count);
+    }), data.size());
+
+    benchmark::report("whirl::regex (istream)", benchmark::measure([&]() {
+        std::istringstream iss(data);
+        std::istream& ins = iss;
+        std::size_t count = 0;
+
+        for (whirl::next_while(ins, whirl::space); !whirl::is(ins, whirl::end); ++count)
+        {
+            number(ins);
+            whirl::next_while(ins, whirl::space);
+        }
+
+        benchmark::keep(count);
+    }), data.size());
+
+    benchmark::report("whirl predicates (string_view)", benchmark::measure([&]() {
+        std::string_view ins = data;
+        std::size_t count = 0;
+
+        for (whirl::next_while(ins, whirl::space); !ins.empty(); ++count)
+        {
+            if (whirl::is(ins, whirl::negative_sign))
+                read_sign(ins);
+
+            if (whirl::is(ins, whirl::zero))
+                whirl::next(ins);
+            else if (whirl::is(ins, whirl::non_zero_digit))
+                read_digits(ins);
+            else
+                throw whirl::unexpected_input{};
+
+            whirl::next_while(ins, whirl::space);
+        }
+
+        benchmark::keep(count);
+    }), data.size());
+
+    return EXIT_SUCCESS;
+}
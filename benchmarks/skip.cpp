@@ -0,0 +1,82 @@
+#include <string>
+#include <string_view>
+
+#include "benchmark.hpp"
+#include "skip.hpp"
+
+
+namespace
+{
+    // Assignments separated by whitespace, line comments and block comments.
+    std::string source_data(std::size_t count)
+    {
+        std::string data;
+
+        for (std::size_t idx = 0; idx < count; ++idx)
+        {
+            data += "value = 42;";
+            data += idx % 4 == 0 ? "  # set the value\n" : "\n";
+            data += idx % 16 == 0 ? "/* the next values are\n   computed elsewhere */\n" : "    ";
+        }
+
+        return data;
+    }
+
+    // whitespace and comments skipped with next_while and comment loops
+    void skip_by_hand(std::string_view& ins)
+    {
+        for (;;)
+        {
+            whirl::next_while(ins, whirl::space);
+
+            if (whirl::is(ins, '#'))
+            {
+                whirl::next_while(ins, whirl::is_not('\n'));
+            }
+            else if (ins.substr(0, 2) == "/*")
+            {
+                ins.remove_prefix(2);
+
+                while (ins.substr(0, 2) != "*/")
+                    whirl::next(ins);
+
+                ins.remove_prefix(2);
+            }
+            else
+            {
+                break;
+            }
+        }
+    }
+
+    template <typename F>
+    std::size_t count_tokens(std::string_view ins, F skip)
+    {
+        std::size_t count = 0;
+
+        for (skip(ins); !ins.empty(); skip(ins))
+        {
+            whirl::next_while(ins, whirl::is_none_of(' ', '\n'));
+            ++count;
+        }
+
+        return count;
+    }
+}
+
+
+// Skips whitespace and comments between tokens with hand written loops and with a skipper.
+int main()
+{
+    const auto source = source_data(300000);
+
+    benchmark::report("next_while and comment loops", benchmark::measure([&]() {
+        benchmark::keep(count_tokens(source, skip_by_hand));
+    }), source.size());
+
+    const auto skipper = whirl::skip(whirl::space, "#", "/*", "*/");
+
+    benchmark::report("skipper", benchmark::measure([&]() {
+        benchmark::keep(count_tokens(source, skipper));
+    }), source.size());
+}
@@ -0,0 +1,37 @@
+#include <sstream>
+
+#include "benchmark.hpp"
+#include "sequential.hpp"
+#include "structural_index.hpp"
+
+
+// Reads sequential data with the character-wise reader and with the two-phase reader built on a
+// structural index.
+int main()
+{
+    const auto data = benchmark::sequential_data(1000000);
+
+    benchmark::report("read_data_entries (istream)", benchmark::measure([&]() {
+        std::istringstream ins(data);
+        whirl::code_position pos{ 1, 1 };
+
+        benchmark::keep(sequential::read_data_entries(ins, pos).size());
+    }), data.size());
+
+    benchmark::report("read_data_entries (string_view)", benchmark::measure([&]() {
+        std::string_view ins = data;
+        whirl::code_position pos{ 1, 1 };
+
+        benchmark::keep(sequential::read_data_entries(ins, pos).size());
+    }), data.size());
+
+    benchmark::report("structural_index", benchmark::measure([&]() {
+        benchmark::keep(whirl::structural_index(data, whirl::space).size());
+    }), data.size());
+
+    benchmark::report("read_indexed_data_entries", benchmark::measure([&]() {
+        whirl::code_position pos{ 1, 1 };
+
+        benchmark::keep(sequential::read_indexed_data_entries(data, pos).size());
+    }), data.size());
+}
@@ -0,0 +1,120 @@
+#include <string>
+#include <string_view>
+
+#include "benchmark.hpp"
+#include "sequential.hpp"
+#include "unicode.hpp"
+
+
+namespace
+{
+    // the up front conversion replaced by utf16_source, as std::wstring_convert would do it
+    std::u32string to_utf32(std::u16string_view text)
+    {
+        std::u32string result;
+
+        result.reserve(text.size());
+
+        auto first = text.data();
+        const auto last = first + text.size();
+
+        while (first != last)
+        {
+            char32_t code_point;
+
+            const auto length = whirl::detail::decode_utf16(first, last, code_point);
+
+            if (length == 0)
+                throw whirl::unexpected_input{ };
+
+            result += code_point;
+            first += length;
+        }
+
+        return result;
+    }
+
+    std::u16string widen(const std::string& text)
+    {
+        return std::u16string(text.begin(), text.end());
+    }
+
+    // Words separated by spaces, of which every fourth one contains a surrogate pair.
+    std::u16string word_data(std::size_t count)
+    {
+        std::u16string data;
+
+        for (std::size_t idx = 0; idx < count; ++idx)
+            data += idx % 4 == 0 ? u"gr\u00FC\U0001F600e " : u"hello ";
+
+        return data;
+    }
+
+    template <typename I>
+    std::size_t count_words(I& ins)
+    {
+        std::size_t count = 0;
+
+        while (!whirl::is(ins, whirl::end))
+        {
+            whirl::next_while(ins, whirl::is_not(U' '));
+            whirl::next_while(ins, whirl::is(U' '));
+            ++count;
+        }
+
+        return count;
+    }
+
+    template <typename I>
+    void run_numbers(const char* name, const std::u16string& numbers)
+    {
+        benchmark::report(name, benchmark::measure([&]() {
+            I ins(numbers);
+            whirl::code_position pos{ 1, 1 };
+
+            benchmark::keep(sequential::read_data_entries(ins, pos).size());
+        }), numbers.size() * sizeof(char16_t));
+    }
+
+    template <typename I>
+    void run_words(const char* name, const std::u16string& words)
+    {
+        benchmark::report(name, benchmark::measure([&]() {
+            I ins(words);
+
+            benchmark::keep(count_words(ins));
+        }), words.size() * sizeof(char16_t));
+    }
+}
+
+
+// Parses UTF-16 as code points, once converted to UTF-32 up front and once decoded on the fly,
+// validating and trusting the input.
+int main()
+{
+    const auto numbers = widen(benchmark::sequential_data(1000000));
+    const auto words = word_data(1000000);
+
+    benchmark::report("numbers, convert, then parse", benchmark::measure([&]() {
+        const auto converted = to_utf32(numbers);
+
+        std::u32string_view ins = converted;
+        whirl::code_position pos{ 1, 1 };
+
+        benchmark::keep(sequential::read_data_entries(ins, pos).size());
+    }), numbers.size() * sizeof(char16_t));
+
+    run_numbers<whirl::utf16_source>("numbers, utf16_source", numbers);
+    run_numbers<whirl::trusted_utf16_source>("numbers, trusted_utf16_source", numbers);
+
+    benchmark::report("words, convert, then parse", benchmark::measure([&]() {
+        const auto converted = to_utf32(words);
+
+        std::u32string_view ins = converted;
+
+        benchmark::keep(count_words(ins));
+    }), words.size() * sizeof(char16_t));
+
+    run_words<whirl::utf16_source>("words, utf16_source", words);
+    run_words<whirl::trusted_utf16_source>("words, trusted_utf16_source", words);
+}
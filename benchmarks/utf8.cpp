@@ -0,0 +1,168 @@
+#include <string>
+#include <string_view>
+
+#include "benchmark.hpp"
+#include "lexeme.hpp"
+#include "sequential.hpp"
+#include "unicode.hpp"
+
+
+namespace
+{
+    // the up front conversion replaced by utf8_source, decoding one code point at a time
+    std::u32string decode_all(std::string_view text)
+    {
+        std::u32string result;
+
+        result.reserve(text.size());
+
+        auto first = reinterpret_cast<const unsigned char*>(text.data());
+        const auto last = first + text.size();
+
+        while (first != last)
+        {
+            char32_t code_point;
+
+            const auto length = whirl::detail::decode_utf8(first, last, code_point);
+
+            if (length == 0)
+                throw whirl::unexpected_input{ };
+
+            result += code_point;
+            first += length;
+        }
+
+        return result;
+    }
+
+    // Words separated by spaces, of which every fourth one contains non-ASCII characters.
+    std::string word_data(std::size_t count)
+    {
+        std::string data;
+
+        for (std::size_t idx = 0; idx < count; ++idx)
+            data += idx % 4 == 0 ? "gr\xC3\xBC\xC3\x9F""e " : "hello ";
+
+        return data;
+    }
+
+    // validation as by decoding
+    void validate_all(std::string_view text)
+    {
+        auto first = reinterpret_cast<const unsigned char*>(text.data());
+        const auto last = first + text.size();
+
+        while (first != last)
+        {
+            char32_t code_point;
+
+            const auto length = whirl::detail::decode_utf8(first, last, code_point);
+
+            if (length == 0)
+                throw whirl::unexpected_input{ };
+
+            first += length;
+        }
+    }
+
+    template <typename I>
+    std::size_t count_words(I& ins)
+    {
+        const whirl::code_unit_class word_class{ whirl::is_not(' ') };
+
+        std::size_t count = 0;
+
+        while (!whirl::is(ins, whirl::end))
+        {
+            whirl::next_while_view(ins, word_class);
+            whirl::next(ins);
+            ++count;
+        }
+
+        return count;
+    }
+
+    template <typename I>
+    std::size_t count_code_points(I& ins)
+    {
+        std::size_t count = 0;
+
+        while (!whirl::is(ins, whirl::end))
+        {
+            whirl::next_while(ins, whirl::is_not(U' '));
+            whirl::next_while(ins, whirl::is(U' '));
+            ++count;
+        }
+
+        return count;
+    }
+}
+
+
+// Parses UTF-8 as code points, once converted to UTF-32 up front and once decoded on the fly.
+// Validates and transcodes whole buffers, and scans UTF-8 validated up front and on the fly.
+int main()
+{
+    const auto numbers = benchmark::sequential_data(1000000);
+    const auto words = word_data(1000000);
+
+    benchmark::report("numbers, convert, then parse", benchmark::measure([&]() {
+        const auto converted = decode_all(numbers);
+
+        std::u32string_view ins = converted;
+        whirl::code_position pos{ 1, 1 };
+
+        benchmark::keep(sequential::read_data_entries(ins, pos).size());
+    }), numbers.size());
+
+    benchmark::report("numbers, utf8_source", benchmark::measure([&]() {
+        whirl::utf8_source ins(numbers);
+        whirl::code_position pos{ 1, 1 };
+
+        benchmark::keep(sequential::read_data_entries(ins, pos).size());
+    }), numbers.size());
+
+    benchmark::report("words, convert, then parse", benchmark::measure([&]() {
+        const auto converted = decode_all(words);
+
+        std::u32string_view ins = converted;
+
+        benchmark::keep(count_code_points(ins));
+    }), words.size());
+
+    benchmark::report("words, utf8_source", benchmark::measure([&]() {
+        whirl::utf8_source ins(words);
+
+        benchmark::keep(count_code_points(ins));
+    }), words.size());
+
+    benchmark::report("words, decode", benchmark::measure([&]() {
+        validate_all(words);
+    }), words.size());
+
+    benchmark::report("words, validate_utf8", benchmark::measure([&]() {
+        whirl::validate_utf8(words);
+    }), words.size());
+
+    benchmark::report("words, decode to UTF-32", benchmark::measure([&]() {
+        benchmark::keep(decode_all(words).size());
+    }), words.size());
+
+    benchmark::report("words, to_utf32", benchmark::measure([&]() {
+        benchmark::keep(whirl::to_utf32(words).size());
+    }), words.size());
+
+    benchmark::report("words, validate, then scan", benchmark::measure([&]() {
+        whirl::validate_utf8(words);
+
+        std::string_view ins = words;
+
+        benchmark::keep(count_words(ins));
+    }), words.size());
+
+    benchmark::report("words, validating_utf8_source", benchmark::measure([&]() {
+        whirl::validating_utf8_source ins(words);
+
+        benchmark::keep(count_words(ins));
+    }), words.size());
+}
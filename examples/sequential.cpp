@@ -1,8 +1,95 @@
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <vector>
+
 #include "sequential.hpp"
 
 
+// sequential --batch [--unordered] [--threads <count>] <input file>...
+//
+// Reads every input file on a work-stealing thread pool and writes its entries to the input path
+// with ".out" appended. Errors are reported per file.
+int run_batch(int argc, char** argv)
+{
+    auto order = sequential::delivery::ordered;
+    auto threads = static_cast<std::size_t>(std::thread::hardware_concurrency());
+
+    std::vector<std::string> paths;
+
+    for (int idx = 2; idx < argc; ++idx)
+    {
+        if (std::strcmp(argv[idx], "--unordered") == 0)
+        {
+            order = sequential::delivery::unordered;
+        }
+        else if (std::strcmp(argv[idx], "--threads") == 0 && idx + 1 < argc)
+        {
+            threads = static_cast<std::size_t>(std::strtoul(argv[++idx], nullptr, 10));
+        }
+        else
+        {
+            paths.emplace_back(argv[idx]);
+        }
+    }
+
+    if (paths.empty())
+    {
+        std::cerr << "missing input files\n";
+        return EXIT_FAILURE;
+    }
+
+    whirl::work_stealing_pool pool(threads);
+
+    std::size_t failures = 0;
+
+    sequential::read_data_files(paths, pool, [&failures](sequential::file_result&& result) {
+        try
+        {
+            if (result.error)
+                std::rethrow_exception(result.error);
+
+            std::ofstream ofs(result.path + ".out");
+
+            if (!ofs.is_open())
+            {
+                std::cerr << result.path << ": output file can't be opened\n";
+                ++failures;
+                return;
+            }
+
+            for (auto temperature : result.entries)
+                ofs << temperature << " ";
+
+            std::cout << result.path << ": " << result.entries.size() << " entries\n";
+        }
+        catch (const whirl::unexpected_input&)
+        {
+            std::cerr << result.path << ": unexpected input at ("
+                << result.position.row
+                << ", "
+                << result.position.col
+                << ")\n";
+
+            ++failures;
+        }
+        catch (const std::exception& error)
+        {
+            std::cerr << result.path << ": " << error.what() << '\n';
+            ++failures;
+        }
+    }, order);
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+
 int main(int argc, char** argv)
 {
+    if (argc > 1 && std::strcmp(argv[1], "--batch") == 0)
+        return run_batch(argc, argv);
+
     if (argc != 3)
     {
         if(argc < 2)
@@ -38,8 +125,8 @@ int main(int argc, char** argv)
 
     try
     {
-        for(auto temperature : sequential::read_data_entries(ifs, pos))
-            ofs << temperature << " ";
+        // entries are written as soon as they are read
+        sequential::read_data_entries(ifs, pos, std::ostream_iterator<int>(ofs, " "));
 
         ofs.close();
 
@@ -15,12 +15,26 @@
 // =================================================================================================
 
 
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
 #include <fstream>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <mutex>
+#include <optional>
 #include <sstream>
 #include <deque>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
 
 #include "whirl.hpp"
+#include "structural_index.hpp"
+#include "parallel.hpp"
+#include "mapped_file.hpp"
 
 
 namespace sequential
@@ -33,24 +47,264 @@ namespace sequential
     constexpr auto read_digit = whirl::next(whirl::as_digit<int>);
     constexpr auto read_digit_sequence = whirl::next_while(whirl::digit, whirl::as_digit<int>);
 
-    auto read_data_entries(std::istream& ins, whirl::code_position& pos)
-    {
-        std::vector<int> temperatures;
+    // Reads a single decimal-whole-number.
+    constexpr auto read_data_entry = [](auto& ins, whirl::code_position& pos) {
+        const auto numtok = whirl::is(ins, whirl::zero) ?
+            read_digit(ins, pos).as_signed() :
+            read_digit_sequence(read_digit(read_sign(ins, pos), ins, pos), ins, pos);
+
+        return numtok.value();
+    };
 
+    // Calls visit(int) for every entry as soon as it is read, hence the memory needed doesn't
+    // depend on the size of the input. Entries read before an error have been visited already.
+    template <
+        typename I,
+        typename F,
+        typename = whirl::requires_t<whirl::is_input_source_type<I>>,
+        typename = std::enable_if_t<std::is_invocable_v<F&, int>>
+    >
+    void for_each_data_entry(I& ins, whirl::code_position& pos, F&& visit)
+    {
         whirl::next_while(ins, pos, whirl::space);
 
         while(whirl::is(ins, number))
         {
-            const auto numtok = whirl::is(ins, whirl::zero) ?
-                read_digit(ins, pos).as_signed() :
-                read_digit_sequence(read_digit(read_sign(ins, pos), ins, pos), ins, pos);
-
-            temperatures.push_back(numtok.value());
+            visit(read_data_entry(ins, pos));
 
             whirl::next_while(ins, pos, whirl::space);
         }
 
         whirl::next_is(ins, pos, whirl::end);
+    }
+
+    // Writes every entry to an output iterator as soon as it is read. Returns the iterator past the
+    // last entry written.
+    template <typename I, typename O, typename = whirl::requires_t<whirl::is_input_source_type<I>>>
+    O read_data_entries(I& ins, whirl::code_position& pos, O out)
+    {
+        for_each_data_entry(ins, pos, [&out](int entry) {
+            *out = entry;
+            ++out;
+        });
+
+        return out;
+    }
+
+    template <typename I, typename = whirl::requires_t<whirl::is_input_source_type<I>>>
+    auto read_data_entries(I& ins, whirl::code_position& pos)
+    {
+        std::vector<int> temperatures;
+
+        read_data_entries(ins, pos, std::back_inserter(temperatures));
+
+        return temperatures;
+    }
+
+    // Reads the entries of a buffer on a thread pool. Errors are reported as
+    // whirl::parallel_parse_error with the offset and position relative to the whole buffer.
+    template <typename T>
+    auto read_data_entries_parallel(std::string_view text, whirl::code_position& pos, T& pool)
+    {
+        return whirl::parse_parallel(text, pos, whirl::space,
+            [](std::string_view& ins, whirl::code_position& chunk_pos) {
+                return read_data_entries(ins, chunk_pos);
+            },
+            pool);
+    }
+
+    // The outcome of reading one file of a batch. The error is either whirl::unexpected_input, in
+    // which case position refers to the unexpected character, or an error opening the file.
+    struct file_result
+    {
+        std::size_t index;
+        std::string path;
+        std::vector<int> entries;
+        whirl::code_position position;
+        std::exception_ptr error;
+    };
+
+    enum class delivery { ordered, unordered };
+
+    // Files of at least this size are split into chunks, which idle workers steal.
+    constexpr std::size_t parallel_file_size = std::size_t{ 4 } << 20;
+
+    inline file_result read_data_file(
+        std::size_t index, const std::string& path, whirl::work_stealing_pool& pool)
+    {
+        file_result result{ index, path, { }, { 1, 1 }, nullptr };
+
+        try
+        {
+            const whirl::mapped_file file(path);
+
+            if (file.size() >= parallel_file_size)
+            {
+                result.entries = read_data_entries_parallel(file.view(), result.position, pool);
+            }
+            else
+            {
+                auto ins = file.view();
+
+                result.entries = read_data_entries(ins, result.position);
+            }
+        }
+        catch (...)
+        {
+            result.error = std::current_exception();
+        }
+
+        return result;
+    }
+
+    // Reads every file on the pool and calls deliver(file_result&&) on the calling thread, either
+    // in the order of the paths or as soon as a file is read. An error only affects the result of
+    // its file. Must not be called by a task of the pool.
+    template <typename F>
+    void read_data_files(
+        const std::vector<std::string>& paths,
+        whirl::work_stealing_pool& pool,
+        F&& deliver,
+        delivery order = delivery::ordered)
+    {
+        std::mutex mutex;
+        std::condition_variable ready;
+        std::deque<file_result> finished;
+
+        for (std::size_t idx = 0; idx < paths.size(); ++idx)
+        {
+            pool.submit([&, idx]() {
+                auto result = read_data_file(idx, paths[idx], pool);
+
+                // notifying under the lock keeps the condition variable alive until then
+                std::lock_guard<std::mutex> lock{ mutex };
+
+                finished.push_back(std::move(result));
+                ready.notify_one();
+            });
+        }
+
+        std::vector<std::optional<file_result>> reordered(
+            order == delivery::ordered ? paths.size() : 0);
+
+        std::size_t received = 0;
+        std::size_t next = 0;
+
+        // the tasks refer to the locals, hence all of them have to finish before unwinding
+        const auto receive = [&]() {
+            std::unique_lock<std::mutex> lock{ mutex };
+
+            ready.wait(lock, [&finished]() { return !finished.empty(); });
+
+            auto result = std::move(finished.front());
+
+            finished.pop_front();
+            ++received;
+
+            return result;
+        };
+
+        try
+        {
+            while (received < paths.size())
+            {
+                auto result = receive();
+
+                if (order == delivery::unordered)
+                {
+                    deliver(std::move(result));
+                    continue;
+                }
+
+                reordered[result.index] = std::move(result);
+
+                for (; next < paths.size() && reordered[next]; ++next)
+                {
+                    deliver(std::move(*reordered[next]));
+                    reordered[next].reset();
+                }
+            }
+        }
+        catch (...)
+        {
+            while (received < paths.size())
+                receive();
+
+            throw;
+        }
+    }
+
+    // Converts the entry starting at idx of a token, which is known to contain no whitespace, and
+    // moves idx past it. Like for the streamed reader, entries don't need to be separated, e.g.
+    // "007" are three entries. The token bounds make end checks unnecessary. On error idx is the
+    // offset of the unexpected character, e.g. the digit overflowing an int.
+    inline int convert_data_entry(std::string_view token, std::size_t& idx)
+    {
+        if (token[idx] == '0')
+        {
+            ++idx;
+            return 0;
+        }
+
+        const auto negative = token[idx] == '-';
+
+        if (negative)
+            ++idx;
+
+        const auto first = idx;
+        const auto limit = static_cast<unsigned>(std::numeric_limits<int>::max()) + negative;
+
+        unsigned magnitude = 0;
+
+        for (; idx < token.size(); ++idx)
+        {
+            const auto digit = static_cast<unsigned>(token[idx] - '0');
+
+            if (digit > 9)
+                break;
+
+            if (magnitude > (limit - digit) / 10)
+                throw whirl::unexpected_input{};
+
+            magnitude = magnitude * 10 + digit;
+        }
+
+        if (idx == first)
+            throw whirl::unexpected_input{};
+
+        return negative ? static_cast<int>(0u - magnitude) : static_cast<int>(magnitude);
+    }
+
+    // Reads the entries of a buffer in two phases. The separators are located in bulk by a
+    // structural index first, then the entries of every token are converted on their own.
+    inline auto read_indexed_data_entries(std::string_view text, whirl::code_position& pos)
+    {
+        const auto index = whirl::structural_index(text, whirl::space);
+
+        std::vector<int> temperatures;
+
+        temperatures.reserve(index.size());
+
+        for (const auto token : index)
+        {
+            std::size_t idx = 0;
+
+            try
+            {
+                while (idx < token.size())
+                    temperatures.push_back(convert_data_entry(token, idx));
+            }
+            catch (const whirl::unexpected_input&)
+            {
+                const auto offset = static_cast<std::size_t>(token.data() - text.data());
+
+                pos.advance(text.substr(0, offset + idx));
+
+                throw;
+            }
+        }
+
+        pos.advance(text);
 
         return temperatures;
     }
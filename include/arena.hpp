@@ -0,0 +1,201 @@
+#ifndef __ARENA_HPP__
+#define __ARENA_HPP__
+
+
+// Monotonic allocation of parse results, e.g. lists and syntax tree nodes. Allocating is bumping a
+// pointer and deallocating does nothing, the memory of a whole parse is given back at once by
+// resetting the arena. Blocks are kept for the next parse, so parsing repeatedly into the same
+// arena allocates from the heap only until the largest parse fits.
+//
+//   whirl::arena arena;
+//
+//   const auto values = whirl::collect(whirl::parse_view(ins, pos, read_value), arena);
+//   const auto node = arena.make<sum_node>(values);
+//   ...
+//   arena.reset();
+//
+// Arenas are polymorphic memory resources, hence std::pmr containers allocate from them.
+
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace whirl
+{
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // arenas
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // Blocks are allocated from the upstream resource, each one at least twice as large as the
+    // one before. Arenas are neither copyable nor movable, as containers refer to them.
+    class arena : public std::pmr::memory_resource
+    {
+
+    public:
+
+        static constexpr std::size_t default_block_size = 4096;
+
+
+        explicit arena(
+            std::size_t initial_block_size = default_block_size,
+            std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+            : m_next_block_size{ std::max<std::size_t>(initial_block_size, 64) }
+            , m_upstream{ upstream }
+        { }
+
+        arena(const arena&) = delete;
+        arena& operator=(const arena&) = delete;
+
+        ~arena() override
+        {
+            this->release();
+        }
+
+        // Frees everything allocated before in O(1), keeping the blocks for reuse.
+        void reset() noexcept
+        {
+            m_block = 0;
+            m_used = 0;
+        }
+
+        // Gives the blocks back to the upstream resource.
+        void release() noexcept
+        {
+            for (const auto& block : m_blocks)
+                m_upstream->deallocate(block.data, block.size, alignof(std::max_align_t));
+
+            m_blocks.clear();
+            this->reset();
+        }
+
+        // the number of bytes held, used or not
+        std::size_t capacity() const noexcept
+        {
+            std::size_t result = 0;
+
+            for (const auto& block : m_blocks)
+                result += block.size;
+
+            return result;
+        }
+
+        // Constructs an object in the arena. Its destructor is never called, hence it must not own
+        // memory outside the arena.
+        template <typename T, typename... As>
+        T* make(As&&... args)
+        {
+            const auto object = static_cast<T*>(this->allocate(sizeof(T), alignof(T)));
+
+            // members like std::pmr containers get the arena as allocator as well
+            std::pmr::polymorphic_allocator<T>{ this }.construct(
+                object, std::forward<As>(args)...);
+
+            return object;
+        }
+
+    private:
+
+        struct block
+        {
+            std::byte* data;
+            std::size_t size;
+        };
+
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+            for (;;)
+            {
+                if (m_block < m_blocks.size())
+                {
+                    auto space = m_blocks[m_block].size - m_used;
+                    void* address = m_blocks[m_block].data + m_used;
+
+                    if (std::align(alignment, bytes, address, space))
+                    {
+                        m_used = m_blocks[m_block].size - space + bytes;
+                        return address;
+                    }
+
+                    // the rest of a block is wasted, but a block kept for reuse may fit
+                    if (m_block + 1 < m_blocks.size())
+                    {
+                        ++m_block;
+                        m_used = 0;
+                        continue;
+                    }
+                }
+
+                this->grow(bytes + alignment);
+            }
+        }
+
+        void do_deallocate(void*, std::size_t, std::size_t) noexcept override
+        { }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+
+        // appends a block of at least the given size and makes it the current one
+        void grow(std::size_t min_size)
+        {
+            const auto size = std::max(m_next_block_size, min_size);
+            const auto data = static_cast<std::byte*>(
+                m_upstream->allocate(size, alignof(std::max_align_t)));
+
+            m_blocks.push_back(block{ data, size });
+            m_block = m_blocks.size() - 1;
+            m_used = 0;
+            m_next_block_size = size * 2;
+        }
+
+        std::vector<block> m_blocks;
+        std::size_t m_block = 0;
+        std::size_t m_used = 0;
+        std::size_t m_next_block_size;
+        std::pmr::memory_resource* m_upstream;
+
+    };
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // arena containers
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    template <typename T>
+    using arena_vector = std::pmr::vector<T>;
+
+    template <typename C>
+    using basic_arena_string = std::pmr::basic_string<C>;
+
+    using arena_string = basic_arena_string<char>;
+
+    // Collects the elements of a range, e.g. a parsed range, in a vector allocated from the
+    // memory resource.
+    template <typename R>
+    auto collect(R&& range, std::pmr::memory_resource& resource)
+    {
+        using value_type = std::decay_t<decltype(*std::begin(range))>;
+
+        arena_vector<value_type> result{ &resource };
+
+        for (auto&& value : range)
+            result.push_back(std::forward<decltype(value)>(value));
+
+        return result;
+    }
+
+}
+
+
+#endif /*__ARENA_HPP__*/
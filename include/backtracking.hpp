@@ -0,0 +1,280 @@
+#ifndef __BACKTRACKING_HPP__
+#define __BACKTRACKING_HPP__
+
+
+// Bounded backtracking for grammars, which are almost LL(1). A consumer is attempted on a
+// rewindable input source and backed out of if it fails, so the next alternative starts at the
+// same position.
+//
+//   if (const auto time = whirl::attempt(ins, pos, read_time))
+//       ...
+//   else
+//       const auto date = read_date(ins, pos);
+//
+// String views are rewindable at no cost. Other input sources, e.g. streams, are made rewindable
+// by wrapping them in a replay source, which keeps a bounded history of the characters consumed.
+
+
+#include <cstddef>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "whirl.hpp"
+
+
+namespace whirl
+{
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // replay sources
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // Consumes another input source, which has to outlive it, and keeps the last consumed
+    // characters in a ring buffer. Rewinding replays them from the buffer before consuming the
+    // underlying source again. Marks are valid as long as at most history_size characters have
+    // been consumed since, rewinding further throws std::length_error.
+    template <typename I>
+    class replay_source
+    {
+
+        static_assert(is_input_source_type_v<I>);
+
+        using traits = input_source_traits<I>;
+
+    public:
+
+        using char_type = typename traits::char_type;
+
+        // the number of characters consumed before
+        struct mark_type
+        {
+            std::size_t offset;
+        };
+
+        static constexpr std::size_t default_history_size = 4096;
+
+
+        // The history size is rounded up to a power of two.
+        explicit replay_source(I& ins, std::size_t history_size = default_history_size)
+            : m_ins{ &ins }
+            , m_history(round_up(history_size))
+            , m_mask{ m_history.size() - 1 }
+        { }
+
+        char_type look_ahead()
+        {
+            if (m_consumed == m_fetched && !this->fetch())
+                return traits::look_ahead(*m_ins);
+
+            return m_history[m_consumed & m_mask];
+        }
+
+        void ignore()
+        {
+            if (m_consumed < m_fetched || this->fetch())
+                ++m_consumed;
+        }
+
+        bool at_end()
+        {
+            return m_consumed == m_fetched && traits::is_end(*m_ins);
+        }
+
+        mark_type mark() const noexcept
+        {
+            return mark_type{ m_consumed };
+        }
+
+        void rewind(const mark_type& mark)
+        {
+            if (mark.offset > m_consumed || m_fetched - mark.offset > m_history.size())
+                throw std::length_error{ "mark beyond the replay history" };
+
+            m_consumed = mark.offset;
+        }
+
+    private:
+
+        // Moves the next character of the underlying source to the history. Returns false at the
+        // end of the underlying source.
+        bool fetch()
+        {
+            if (traits::is_end(*m_ins))
+                return false;
+
+            m_history[m_fetched & m_mask] = traits::read(*m_ins);
+            ++m_fetched;
+
+            return true;
+        }
+
+        static std::size_t round_up(std::size_t size) noexcept
+        {
+            std::size_t result = 1;
+
+            while (result < size)
+                result *= 2;
+
+            return result;
+        }
+
+        I* m_ins;
+        std::vector<char_type> m_history;
+        std::size_t m_mask;
+
+        // characters consumed by the parser and read from the underlying source, which is at most
+        // the look ahead character more
+        std::size_t m_consumed = 0;
+        std::size_t m_fetched = 0;
+
+    };
+
+    template <typename I>
+    struct input_source_traits<replay_source<I>>
+    {
+        using char_type = typename replay_source<I>::char_type;
+        using mark_type = typename replay_source<I>::mark_type;
+
+        static char_type look_ahead(replay_source<I>& ins)
+        {
+            return ins.look_ahead();
+        }
+
+        static char_type read(replay_source<I>& ins)
+        {
+            const auto chr = ins.look_ahead();
+
+            ins.ignore();
+
+            return chr;
+        }
+
+        static void ignore(replay_source<I>& ins)
+        {
+            ins.ignore();
+        }
+
+        static bool is_end(replay_source<I>& ins)
+        {
+            return ins.at_end();
+        }
+
+        static mark_type mark(replay_source<I>& ins) noexcept
+        {
+            return ins.mark();
+        }
+
+        static void rewind(replay_source<I>& ins, const mark_type& mark)
+        {
+            ins.rewind(mark);
+        }
+    };
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // 'attempt' overloads
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // Calls the consumer and returns its result, or true for consumers returning nothing. If the
+    // consumer throws unexpected_input, the input source and the code position are rewound and
+    // std::nullopt, or false respectively, is returned.
+    template <
+        typename I,
+        typename F,
+        typename = requires_t<is_input_source_type<I>>,
+        typename = std::enable_if_t<std::is_invocable_v<const F&, I&>>
+    >
+    auto attempt(I& ins, const F& consumer)
+    {
+        static_assert(
+            is_rewindable_input_source_type_v<I>,
+            "the input source has to be rewindable, e.g. by wrapping it in a replay_source"
+        );
+
+        using traits = input_source_traits<I>;
+        using result_type = std::invoke_result_t<const F&, I&>;
+
+        const auto mark = traits::mark(ins);
+
+        try
+        {
+            if constexpr (std::is_void_v<result_type>)
+            {
+                consumer(ins);
+                return true;
+            }
+            else
+            {
+                return std::optional<std::decay_t<result_type>>{ consumer(ins) };
+            }
+        }
+        catch (const unexpected_input&)
+        {
+            traits::rewind(ins, mark);
+
+            if constexpr (std::is_void_v<result_type>)
+                return false;
+            else
+                return std::optional<std::decay_t<result_type>>{ };
+        }
+    }
+
+    template <
+        typename I,
+        typename F,
+        typename = requires_t<is_input_source_type<I>>,
+        typename = std::enable_if_t<std::is_invocable_v<const F&, I&, code_position&>>
+    >
+    auto attempt(I& ins, code_position& pos, const F& consumer)
+    {
+        const auto start_pos = pos;
+
+        auto result = attempt(ins, [&pos, &consumer](I& ins) { return consumer(ins, pos); });
+
+        if (!result)
+            pos = start_pos;
+
+        return result;
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // bound attempts
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    template <typename F>
+    struct bound_attempt
+    {
+
+        explicit constexpr bound_attempt(const F& consumer)
+            : consumer{ consumer }
+        { }
+
+        template <typename I>
+        auto operator()(I& ins) const
+        {
+            return attempt(ins, this->consumer);
+        }
+
+        template <typename I>
+        auto operator()(I& ins, code_position& pos) const
+        {
+            return attempt(ins, pos, this->consumer);
+        }
+
+        F consumer;
+
+    };
+
+    template <typename F>
+    constexpr auto attempt(const F& consumer)
+    {
+        return bound_attempt{ consumer };
+    }
+
+}
+
+
+#endif /*__BACKTRACKING_HPP__*/
@@ -0,0 +1,192 @@
+#ifndef __CHARACTER_SET_HPP__
+#define __CHARACTER_SET_HPP__
+
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+#include "type_traits.hpp"
+
+
+namespace whirl
+{
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // single character probing
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    template <typename P, typename C, typename = requires_t<is_character_type<C>>>
+    constexpr bool satisfies(const P& pred, const C& chr)
+    {
+        character_probe<C> probe{ chr, false };
+
+        return pred.is(probe);
+    }
+
+    template <typename P>
+    constexpr bool satisfies_end(const P& pred)
+    {
+        // mimics the behaviour of std::basic_istream, which yields eof as look ahead at the end
+        character_probe<char> probe{ static_cast<char>(std::char_traits<char>::eof()), true };
+
+        return pred.is(probe);
+    }
+
+    // The value of a character as unsigned code unit, e.g. 0xFF for a char of value -1.
+    template <typename C, typename = requires_t<is_character_type<C>>>
+    constexpr auto code_unit(const C& chr) noexcept
+    {
+        return static_cast<std::make_unsigned_t<C>>(chr);
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // character sets
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // A set over the code units 0 to 255 and the virtual end token. Code units beyond 255 are not
+    // representable and have to be handled by evaluating the original predicates.
+    class character_set
+    {
+
+    public:
+
+        static constexpr std::size_t domain_size = 256;
+        static constexpr std::size_t end_index = domain_size;
+
+        constexpr character_set() noexcept
+            : m_words{ }
+        { }
+
+        // Code units are probed as characters of type C, which matters for the upper half of the
+        // domain if C is signed.
+        template <
+            typename C = char,
+            typename P,
+            typename = requires_t<is_character_type<C>>,
+            typename = requires_t<is_bound_predicate<P>>
+        >
+        static constexpr character_set of(const P& pred)
+        {
+            character_set set;
+
+            for (std::size_t idx = 0; idx < domain_size; ++idx)
+            {
+                if (satisfies(pred, static_cast<C>(idx)))
+                    set.insert(idx);
+            }
+
+            if (satisfies_end(pred))
+                set.insert_end();
+
+            return set;
+        }
+
+        static constexpr character_set end() noexcept
+        {
+            character_set set;
+
+            set.insert_end();
+
+            return set;
+        }
+
+        constexpr bool contains(std::size_t idx) const noexcept
+        {
+            return (m_words[idx / 64] >> (idx % 64)) & 1u;
+        }
+
+        constexpr bool contains_end() const noexcept
+        {
+            return this->contains(end_index);
+        }
+
+        constexpr void insert(std::size_t idx) noexcept
+        {
+            m_words[idx / 64] |= std::uint64_t{ 1 } << (idx % 64);
+        }
+
+        constexpr void insert_end() noexcept
+        {
+            this->insert(end_index);
+        }
+
+        constexpr void erase(std::size_t idx) noexcept
+        {
+            m_words[idx / 64] &= ~(std::uint64_t{ 1 } << (idx % 64));
+        }
+
+        constexpr void erase_end() noexcept
+        {
+            this->erase(end_index);
+        }
+
+        constexpr bool empty() const noexcept
+        {
+            for (auto word : m_words)
+            {
+                if (word != 0)
+                    return false;
+            }
+
+            return true;
+        }
+
+        constexpr bool intersects(const character_set& other) const noexcept
+        {
+            return !(*this & other).empty();
+        }
+
+        constexpr character_set& operator|=(const character_set& other) noexcept
+        {
+            for (std::size_t idx = 0; idx < m_words.size(); ++idx)
+                m_words[idx] |= other.m_words[idx];
+
+            return *this;
+        }
+
+        constexpr character_set& operator&=(const character_set& other) noexcept
+        {
+            for (std::size_t idx = 0; idx < m_words.size(); ++idx)
+                m_words[idx] &= other.m_words[idx];
+
+            return *this;
+        }
+
+        friend constexpr character_set operator|(character_set lhs, const character_set& rhs)
+        {
+            return lhs |= rhs;
+        }
+
+        friend constexpr character_set operator&(character_set lhs, const character_set& rhs)
+        {
+            return lhs &= rhs;
+        }
+
+        friend constexpr bool operator==(const character_set& lhs, const character_set& rhs)
+        {
+            for (std::size_t idx = 0; idx < lhs.m_words.size(); ++idx)
+            {
+                if (lhs.m_words[idx] != rhs.m_words[idx])
+                    return false;
+            }
+
+            return true;
+        }
+
+        friend constexpr bool operator!=(const character_set& lhs, const character_set& rhs)
+        {
+            return !(lhs == rhs);
+        }
+
+    private:
+
+        std::array<std::uint64_t, (domain_size + 1 + 63) / 64> m_words;
+
+    };
+
+}
+
+
+#endif /*__CHARACTER_SET_HPP__*/
@@ -0,0 +1,371 @@
+#ifndef __DELIMITER_HPP__
+#define __DELIMITER_HPP__
+
+
+// Fields running up to a delimiter, e.g. a comma or the end of a line, consumed without checking
+// every character against a predicate. On contiguous sources the delimiter is searched with
+// memchr, or with SSE2 comparisons for several delimiters, and the field is returned as a view
+// into the source. The delimiter itself isn't consumed.
+//
+//   const auto name = whirl::next_until(ins, ',');
+//   const auto value = whirl::next_until_one_of(ins, ',', '\n');
+//   const auto line = whirl::next_until(ins, "\r\n"sv);
+//
+// Fields run up to the end of the input, if there's no delimiter. Delimiters of several characters
+// are supported by contiguous sources only.
+
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <tuple>
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+#include "whirl.hpp"
+#include "scan.hpp"
+#include "lexeme.hpp"
+
+
+namespace whirl
+{
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // delimiter search
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    namespace detail
+    {
+        // the offset of the first of the delimiters in a buffer, or its size
+        template <typename C, typename... Ds>
+        std::size_t find_one_of(const C* first, std::size_t size, Ds... delims) noexcept
+        {
+            if constexpr (sizeof...(Ds) == 1)
+            {
+                // memchr for char buffers
+                const auto found = std::char_traits<C>::find(first, size, C(delims)...);
+
+                return found ? static_cast<std::size_t>(found - first) : size;
+            }
+            else
+            {
+                std::size_t idx = 0;
+
+            #if defined(__SSE2__)
+                if constexpr (sizeof(C) == 1)
+                {
+                    for (; idx + 16 <= size; idx += 16)
+                    {
+                        const auto chars = _mm_loadu_si128(
+                            reinterpret_cast<const __m128i*>(first + idx));
+
+                        auto matches = _mm_setzero_si128();
+
+                        ((matches = _mm_or_si128(matches, _mm_cmpeq_epi8(
+                            chars, _mm_set1_epi8(static_cast<char>(delims))))), ...);
+
+                        if (const auto mask = _mm_movemask_epi8(matches))
+                            return idx + lowest_bit(static_cast<std::uint64_t>(mask));
+                    }
+                }
+            #endif
+
+                for (; idx < size; ++idx)
+                {
+                    if (((first[idx] == C(delims)) || ...))
+                        return idx;
+                }
+
+                return size;
+            }
+        }
+
+        // The offset of the first occurrence of a delimiter in a buffer, or its size. Candidates
+        // are filtered by their first and last character, 16 at a time with SSE2, and verified
+        // afterwards.
+        template <typename C>
+        std::size_t find_delimiter(
+            const C* first, std::size_t size, std::basic_string_view<C> delim) noexcept
+        {
+            using traits_type = std::char_traits<C>;
+
+            if (delim.size() <= 1)
+                return delim.empty() ? 0 : find_one_of(first, size, delim.front());
+
+            if (size < delim.size())
+                return size;
+
+            // the number of offsets a delimiter may start at
+            const auto candidates = size - delim.size() + 1;
+            const auto tail = delim.size() - 1;
+
+            std::size_t idx = 0;
+
+        #if defined(__SSE2__)
+            if constexpr (sizeof(C) == 1)
+            {
+                const auto front = _mm_set1_epi8(static_cast<char>(delim.front()));
+                const auto back = _mm_set1_epi8(static_cast<char>(delim.back()));
+
+                for (; idx + 16 <= candidates; idx += 16)
+                {
+                    const auto fronts = _mm_loadu_si128(
+                        reinterpret_cast<const __m128i*>(first + idx));
+                    const auto backs = _mm_loadu_si128(
+                        reinterpret_cast<const __m128i*>(first + idx + tail));
+
+                    auto mask = static_cast<std::uint64_t>(_mm_movemask_epi8(_mm_and_si128(
+                        _mm_cmpeq_epi8(fronts, front), _mm_cmpeq_epi8(backs, back))));
+
+                    for (; mask; mask &= mask - 1)
+                    {
+                        const auto offset = idx + lowest_bit(mask);
+
+                        if (traits_type::compare(
+                            first + offset + 1, delim.data() + 1, delim.size() - 2) == 0)
+                        {
+                            return offset;
+                        }
+                    }
+                }
+            }
+        #endif
+
+            for (; idx < candidates; ++idx)
+            {
+                if (first[idx] == delim.front()
+                    && traits_type::compare(first + idx, delim.data(), delim.size()) == 0)
+                {
+                    return idx;
+                }
+            }
+
+            return size;
+        }
+
+        template <typename I, typename... Ds>
+        lexeme_t<I> read_until(I& ins, Ds... delims)
+        {
+            using traits = input_source_traits<I>;
+            using char_type = typename traits::char_type;
+
+            if constexpr (is_contiguous_input_source_type_v<I>)
+            {
+                const auto first = traits::data(ins);
+                const auto count = find_one_of(first, traits::size(ins), delims...);
+
+                traits::advance(ins, count);
+
+                return lexeme_t<I>{ first, count };
+            }
+            else
+            {
+                lexeme_t<I> result;
+
+                while (!traits::is_end(ins))
+                {
+                    const auto chr = traits::look_ahead(ins);
+
+                    if (((chr == char_type(delims)) || ...))
+                        break;
+
+                    result.push_back(chr);
+                    traits::ignore(ins);
+                }
+
+                return result;
+            }
+        }
+
+        template <typename I, typename... Ds>
+        lexeme_t<I> read_until(I& ins, code_position& pos, Ds... delims)
+        {
+            const auto result = read_until(ins, delims...);
+
+            using char_type = typename input_source_traits<I>::char_type;
+
+            // a field up to a newline contains none
+            if (((char_type(delims) == char_type('\n')) || ...))
+                pos.advance_columns(std::basic_string_view<char_type>{ result });
+            else
+                pos.advance(std::basic_string_view<char_type>{ result });
+
+            return result;
+        }
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // 'next_until' overloads
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    template <
+        typename I,
+        typename C,
+        typename = requires_t<is_input_source_type<I>>,
+        typename = requires_t<is_character_type<C>>
+    >
+    lexeme_t<I> next_until(I& ins, C delim)
+    {
+        return detail::read_until(ins, delim);
+    }
+
+    template <
+        typename I,
+        typename C,
+        typename = requires_t<is_input_source_type<I>>,
+        typename = requires_t<is_character_type<C>>
+    >
+    lexeme_t<I> next_until(I& ins, code_position& pos, C delim)
+    {
+        return detail::read_until(ins, pos, delim);
+    }
+
+    template <
+        typename I,
+        typename = requires_t<is_contiguous_input_source_type<I>>
+    >
+    lexeme_t<I> next_until(
+        I& ins, std::basic_string_view<typename input_source_traits<I>::char_type> delim)
+    {
+        using traits = input_source_traits<I>;
+
+        const auto first = traits::data(ins);
+        const auto count = detail::find_delimiter(first, traits::size(ins), delim);
+
+        traits::advance(ins, count);
+
+        return lexeme_t<I>{ first, count };
+    }
+
+    template <
+        typename I,
+        typename = requires_t<is_contiguous_input_source_type<I>>
+    >
+    lexeme_t<I> next_until(
+        I& ins,
+        code_position& pos,
+        std::basic_string_view<typename input_source_traits<I>::char_type> delim)
+    {
+        const auto result = next_until(ins, delim);
+
+        pos.advance(result);
+
+        return result;
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // 'next_until_one_of' overloads
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    template <
+        typename I,
+        typename... Cs,
+        typename = requires_t<is_input_source_type<I>>,
+        typename = requires_t<is_character_type<Cs>...>
+    >
+    lexeme_t<I> next_until_one_of(I& ins, Cs... delims)
+    {
+        return detail::read_until(ins, delims...);
+    }
+
+    template <
+        typename I,
+        typename... Cs,
+        typename = requires_t<is_input_source_type<I>>,
+        typename = requires_t<is_character_type<Cs>...>
+    >
+    lexeme_t<I> next_until_one_of(I& ins, code_position& pos, Cs... delims)
+    {
+        return detail::read_until(ins, pos, delims...);
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // bound delimited consumers
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    template <typename... Cs>
+    struct bound_delimited_view_read
+    {
+
+        static_assert((is_character_type_v<Cs> && ...));
+
+
+        explicit constexpr bound_delimited_view_read(Cs... delims)
+            : delims{ delims... }
+        { }
+
+        template <typename I>
+        auto operator()(I& ins) const
+        {
+            return std::apply([&ins](auto... delims) {
+                return detail::read_until(ins, delims...);
+            }, this->delims);
+        }
+
+        template <typename I>
+        auto operator()(I& ins, code_position& pos) const
+        {
+            return std::apply([&ins, &pos](auto... delims) {
+                return detail::read_until(ins, pos, delims...);
+            }, this->delims);
+        }
+
+        std::tuple<Cs...> delims;
+
+    };
+
+    // The delimiter has to outlive the consumer.
+    template <typename C>
+    struct bound_multi_delimited_view_read
+    {
+
+        static_assert(is_character_type_v<C>);
+
+
+        explicit constexpr bound_multi_delimited_view_read(std::basic_string_view<C> delim)
+            : delim{ delim }
+        { }
+
+        template <typename I>
+        auto operator()(I& ins) const
+        {
+            return next_until(ins, this->delim);
+        }
+
+        template <typename I>
+        auto operator()(I& ins, code_position& pos) const
+        {
+            return next_until(ins, pos, this->delim);
+        }
+
+        std::basic_string_view<C> delim;
+
+    };
+
+    template <typename C, typename = requires_t<is_character_type<C>>>
+    constexpr auto next_until(C delim)
+    {
+        return bound_delimited_view_read<C>{ delim };
+    }
+
+    template <typename C>
+    constexpr auto next_until(std::basic_string_view<C> delim)
+    {
+        return bound_multi_delimited_view_read<C>{ delim };
+    }
+
+    template <typename... Cs, typename = requires_t<is_character_type<Cs>...>>
+    constexpr auto next_until_one_of(Cs... delims)
+    {
+        return bound_delimited_view_read<Cs...>{ delims... };
+    }
+
+}
+
+
+#endif /*__DELIMITER_HPP__*/
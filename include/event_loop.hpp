@@ -0,0 +1,275 @@
+#ifndef __EVENT_LOOP_HPP__
+#define __EVENT_LOOP_HPP__
+
+
+// Parsing many non-blocking file descriptors, e.g. sockets or pipes, on a single thread. Every
+// file descriptor gets a resumable parser, which is fed whatever is readable, so a connection
+// waiting for data blocks no other one. The state kept per connection is the resumable parser with
+// its incomplete entry only, the read buffer is shared.
+//
+//   whirl::event_loop loop;
+//
+//   loop.watch(fd, whirl::resumable_parser{ read_entry }, on_entry, on_done);
+//   loop.run();
+//
+// Event loops are available on Linux only, where WHIRL_HAS_EPOLL is defined.
+
+
+#if defined(__linux__)
+
+#include <cerrno>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include "resumable.hpp"
+
+#define WHIRL_HAS_EPOLL 1
+
+
+namespace whirl
+{
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // event loops
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // Connections are served in the order they become readable, with at most one read each per
+    // round, so a fast connection can't starve the others. Throws std::system_error if the
+    // event loop itself fails.
+    class event_loop
+    {
+
+    public:
+
+        static constexpr std::size_t default_buffer_size = 64 * 1024;
+
+
+        explicit event_loop(std::size_t buffer_size = default_buffer_size)
+            : m_buffer(buffer_size > 0 ? buffer_size : 1)
+            , m_epoll{ ::epoll_create1(EPOLL_CLOEXEC) }
+        {
+            if (m_epoll < 0)
+                throw std::system_error{ errno, std::generic_category(), "epoll_create1" };
+        }
+
+        event_loop(const event_loop&) = delete;
+        event_loop& operator=(const event_loop&) = delete;
+
+        // closes the file descriptors still watched
+        ~event_loop()
+        {
+            for (const auto& watched : m_connections)
+                ::close(watched.first);
+
+            ::close(m_epoll);
+        }
+
+        // Takes ownership of the file descriptor and makes it non-blocking. Every entry parsed is
+        // passed to emit. At the end of the input, or after the first error, the file descriptor
+        // is closed and done(parser, error) is called, where error is null after a complete input.
+        // If watching fails, the file descriptor is closed right away.
+        template <typename R, typename E, typename D>
+        void watch(int fd, R parser, E emit, D done)
+        {
+            try
+            {
+                auto watched = std::make_unique<connection_impl<R, E, D>>(
+                    std::move(parser), std::move(emit), std::move(done));
+
+                const auto flags = ::fcntl(fd, F_GETFL);
+
+                if (flags < 0 || ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0)
+                    throw std::system_error{ errno, std::generic_category(), "fcntl" };
+
+                epoll_event event{ };
+
+                event.events = EPOLLIN;
+                event.data.fd = fd;
+
+                if (::epoll_ctl(m_epoll, EPOLL_CTL_ADD, fd, &event) < 0)
+                    throw std::system_error{ errno, std::generic_category(), "epoll_ctl" };
+
+                try
+                {
+                    m_connections.emplace(fd, std::move(watched));
+                }
+                catch (...)
+                {
+                    ::epoll_ctl(m_epoll, EPOLL_CTL_DEL, fd, nullptr);
+                    throw;
+                }
+            }
+            catch (...)
+            {
+                ::close(fd);
+                throw;
+            }
+        }
+
+        // the number of file descriptors watched
+        std::size_t size() const noexcept
+        {
+            return m_connections.size();
+        }
+
+        // Serves the connections until all of them are done.
+        void run()
+        {
+            while (!m_connections.empty())
+                this->run_once(-1);
+        }
+
+        // Waits at most timeout milliseconds, or forever if negative, for readable connections
+        // and serves them. Returns the number of connections served.
+        std::size_t run_once(int timeout)
+        {
+            epoll_event events[max_events];
+
+            const auto count = ::epoll_wait(m_epoll, events, max_events, timeout);
+
+            if (count < 0)
+            {
+                if (errno == EINTR)
+                    return 0;
+
+                throw std::system_error{ errno, std::generic_category(), "epoll_wait" };
+            }
+
+            for (int idx = 0; idx < count; ++idx)
+                this->serve(events[idx].data.fd);
+
+            return static_cast<std::size_t>(count);
+        }
+
+    private:
+
+        static constexpr int max_events = 256;
+
+        struct connection
+        {
+            virtual ~connection() = default;
+
+            // Returns the error ending the connection, if any.
+            virtual std::exception_ptr feed(std::string_view fragment) = 0;
+            virtual void finish(std::exception_ptr error) = 0;
+        };
+
+        template <typename R, typename E, typename D>
+        class connection_impl : public connection
+        {
+
+        public:
+
+            connection_impl(R parser, E emit, D done)
+                : m_parser{ std::move(parser) }
+                , m_emit{ std::move(emit) }
+                , m_done{ std::move(done) }
+            { }
+
+            std::exception_ptr feed(std::string_view fragment) override
+            {
+                try
+                {
+                    m_parser.feed(fragment, m_emit);
+                    return nullptr;
+                }
+                catch (...)
+                {
+                    return std::current_exception();
+                }
+            }
+
+            void finish(std::exception_ptr error) override
+            {
+                if (!error)
+                {
+                    try
+                    {
+                        m_parser.finish(m_emit);
+                    }
+                    catch (...)
+                    {
+                        error = std::current_exception();
+                    }
+                }
+
+                m_done(m_parser, error);
+            }
+
+        private:
+
+            R m_parser;
+            E m_emit;
+            D m_done;
+
+        };
+
+        void serve(int fd)
+        {
+            const auto found = m_connections.find(fd);
+
+            if (found == m_connections.end())
+                return;
+
+            auto& watched = *found->second;
+
+            const auto count = ::read(fd, m_buffer.data(), m_buffer.size());
+
+            std::exception_ptr error;
+
+            if (count > 0)
+            {
+                const std::string_view fragment{ m_buffer.data(), static_cast<std::size_t>(count) };
+
+                error = watched.feed(fragment);
+
+                if (!error)
+                    return;
+            }
+            else if (count < 0)
+            {
+                if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+                    return;
+
+                error = std::make_exception_ptr(
+                    std::system_error{ errno, std::generic_category(), "read" });
+            }
+
+            // the connection is removed first, in case done throws
+            const auto closed = std::move(found->second);
+
+            this->close(found);
+            closed->finish(error);
+        }
+
+        template <typename T>
+        void close(T found)
+        {
+            ::epoll_ctl(m_epoll, EPOLL_CTL_DEL, found->first, nullptr);
+            ::close(found->first);
+
+            m_connections.erase(found);
+        }
+
+        std::vector<char> m_buffer;
+        int m_epoll;
+        std::unordered_map<int, std::unique_ptr<connection>> m_connections;
+
+    };
+
+}
+
+#endif
+
+
+#endif /*__EVENT_LOOP_HPP__*/
@@ -0,0 +1,452 @@
+#ifndef __FIXED_POINT_HPP__
+#define __FIXED_POINT_HPP__
+
+
+// Decimal numbers read directly into scaled integers, e.g. 23.45 as 2345 hundredths, without
+// parsing a double and scaling it, which is slower and loses precision.
+//
+//   const auto hundredths = whirl::read_fixed_point<int, 100>(ins);
+//   const auto rounded = whirl::read_fixed_point<int, 10, whirl::rounding::nearest>(ins);
+//
+// The numbers consist of an optional sign, at least one integer digit, and optionally a decimal
+// point followed by at least one fractional digit. Missing fractional digits count as zeros,
+// surplus ones are truncated or rounded half away from zero. On contiguous char sources digits
+// are validated and converted eight at a time within a 64 bit word.
+
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+
+#include "whirl.hpp"
+#include "scan.hpp"
+
+
+namespace whirl
+{
+
+    // how fractional digits beyond the scale are handled
+    enum class rounding { truncate, nearest };
+
+    // thrown for numbers beyond the range of the result type
+    struct value_out_of_range : unexpected_input { };
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // digit conversion
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    namespace detail
+    {
+        // the number of decimal digits of a power of ten
+        template <typename T>
+        constexpr int decimal_exponent(T scale) noexcept
+        {
+            int exponent = 0;
+
+            for (; scale > 1 && scale % 10 == 0; scale /= 10)
+                ++exponent;
+
+            return scale == 1 ? exponent : -1;
+        }
+
+        template <typename U>
+        constexpr U power_of_ten(int exponent) noexcept
+        {
+            U result = 1;
+
+            for (; exponent > 0; --exponent)
+                result *= 10;
+
+            return result;
+        }
+
+        // Converts the leading digits of eight characters, stored little endian in a word. Returns
+        // the number of digits.
+        inline int convert_eight_digits(std::uint64_t chars, std::uint64_t& value) noexcept
+        {
+            // a byte is a digit, if its high nibble is 3 and adding 6 doesn't carry into it
+            const auto non_digits = ((chars & 0xF0F0F0F0F0F0F0F0) - 0x3030303030303030)
+                | (((chars + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) - 0x3030303030303030);
+
+            const auto count = non_digits == 0
+                ? 8
+                : static_cast<int>(lowest_bit(non_digits) / 8);
+
+            if (count == 0)
+                return 0;
+
+            // the digits move to the most significant bytes, leading zeros fill the others
+            auto digits = (chars - 0x3030303030303030) << (8 * (8 - count));
+
+            digits = (digits * 10) + (digits >> 8);
+            digits = (((digits & 0x000000FF000000FF) * (100 + (1000000ull << 32)))
+                + (((digits >> 16) & 0x000000FF000000FF) * (1 + (10000ull << 32)))) >> 32;
+
+            value = digits;
+
+            return count;
+        }
+
+        // Reads decimal numbers into scaled integers, character by character or, on little endian
+        // targets with GCC builtins, eight digits at a time.
+        template <typename T, T Scale, rounding R>
+        class fixed_point_reader
+        {
+
+            static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>);
+            static_assert(decimal_exponent(Scale) >= 0, "the scale has to be a power of ten");
+
+        public:
+
+            template <typename C>
+            static T read(const C* first, std::size_t size, std::size_t& count)
+            {
+                fixed_point_reader reader;
+
+                count = 0;
+
+                const auto digit_at = [&](std::size_t idx) {
+                    return idx < size ? digit_value(first[idx]) : -1;
+                };
+
+                if (size > 0 && reader.accept_sign(first[0]))
+                    ++count;
+
+                const auto int_start = count;
+
+                count = reader.read_digits(first, size, count, fraction_digits, true);
+
+                if (count == int_start)
+                    throw unexpected_input{ };
+
+                if (count < size && first[count] == C('.'))
+                {
+                    if (digit_at(++count) < 0)
+                        throw unexpected_input{ };
+
+                    count = reader.read_digits(first, size, count, fraction_digits, false);
+
+                    // surplus digits are dropped, but the first one decides about rounding
+                    if (digit_at(count) >= 0)
+                    {
+                        reader.round(digit_at(count));
+
+                        while (digit_at(count) >= 0)
+                            ++count;
+                    }
+                }
+
+                return reader.result();
+            }
+
+            template <typename I>
+            static T read(I& ins, code_position* pos)
+            {
+                using traits = input_source_traits<I>;
+                using char_type = typename traits::char_type;
+
+                fixed_point_reader reader;
+
+                const auto look_ahead_digit = [&ins]() {
+                    return traits::is_end(ins) ? -1 : digit_value(traits::look_ahead(ins));
+                };
+
+                const auto consume = [&ins, pos]() {
+                    pos ? next(ins, *pos) : next(ins);
+                };
+
+                if (!traits::is_end(ins) && reader.accept_sign(traits::look_ahead(ins)))
+                    consume();
+
+                if (look_ahead_digit() < 0)
+                    throw unexpected_input{ };
+
+                for (int digit; (digit = look_ahead_digit()) >= 0; consume())
+                    reader.push_digit(digit, true);
+
+                if (!traits::is_end(ins) && traits::look_ahead(ins) == char_type('.'))
+                {
+                    consume();
+
+                    if (look_ahead_digit() < 0)
+                        throw unexpected_input{ };
+
+                    for (int digit; (digit = look_ahead_digit()) >= 0; consume())
+                    {
+                        if (reader.m_fraction_count == fraction_digits)
+                        {
+                            reader.round(digit);
+
+                            while (look_ahead_digit() >= 0)
+                                consume();
+
+                            break;
+                        }
+
+                        reader.push_digit(digit, false);
+                    }
+                }
+
+                return reader.result();
+            }
+
+        private:
+
+            using magnitude_type = std::make_unsigned_t<T>;
+
+            static constexpr int fraction_digits = decimal_exponent(Scale);
+
+            template <typename C>
+            static int digit_value(C chr) noexcept
+            {
+                return chr >= C('0') && chr <= C('9') ? static_cast<int>(chr - C('0')) : -1;
+            }
+
+            template <typename C>
+            bool accept_sign(C chr) noexcept
+            {
+                if (chr == C('-') && std::is_signed_v<T>)
+                {
+                    m_negative = true;
+                    return true;
+                }
+
+                return chr == C('+');
+            }
+
+            // the largest magnitude of the sign read
+            magnitude_type limit() const noexcept
+            {
+                const auto max = static_cast<magnitude_type>(std::numeric_limits<T>::max());
+
+                return m_negative ? max + 1 : max;
+            }
+
+            // Appends digits converted at once, as integer digits or as fractional ones.
+            void push_digits(std::uint64_t digits, int count, bool integer)
+            {
+                const auto factor = power_of_ten<magnitude_type>(count);
+
+                if (count > std::numeric_limits<magnitude_type>::digits10
+                    || m_magnitude > (this->limit() - digits) / factor
+                    || digits > this->limit())
+                {
+                    throw value_out_of_range{ };
+                }
+
+                m_magnitude = m_magnitude * factor + static_cast<magnitude_type>(digits);
+
+                if (!integer)
+                    m_fraction_count += count;
+            }
+
+            void push_digit(int digit, bool integer)
+            {
+                this->push_digits(static_cast<std::uint64_t>(digit), 1, integer);
+            }
+
+            // Reads a run of digits, but at most max_fraction fractional ones. Returns the offset
+            // after the digits read.
+            template <typename C>
+            std::size_t read_digits(
+                const C* first, std::size_t size, std::size_t idx, int max_fraction, bool integer)
+            {
+                const auto remaining = [&]() {
+                    return integer ? 8 : max_fraction - m_fraction_count;
+                };
+
+            #if defined(__GNUC__) && defined(__BYTE_ORDER__) \
+                && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+                // types too narrow for eight digits are converted one digit at a time
+                if constexpr (sizeof(C) == 1 && std::numeric_limits<magnitude_type>::digits10 >= 8)
+                {
+                    while (idx + 8 <= size && remaining() > 0)
+                    {
+                        std::uint64_t chars;
+
+                        std::memcpy(&chars, first + idx, 8);
+
+                        std::uint64_t digits;
+
+                        auto count = convert_eight_digits(chars, digits);
+
+                        if (count == 0)
+                            return idx;
+
+                        if (count > remaining())
+                        {
+                            // the digits beyond the scale are dropped
+                            digits /= power_of_ten<std::uint64_t>(count - remaining());
+                            count = remaining();
+                        }
+
+                        this->push_digits(digits, count, integer);
+                        idx += static_cast<std::size_t>(count);
+
+                        if (count < 8)
+                            return idx;
+                    }
+                }
+            #endif
+
+                for (; idx < size && remaining() > 0; ++idx)
+                {
+                    const auto digit = digit_value(first[idx]);
+
+                    if (digit < 0)
+                        break;
+
+                    this->push_digit(digit, integer);
+                }
+
+                return idx;
+            }
+
+            void round(int dropped_digit)
+            {
+                if (R == rounding::nearest && dropped_digit >= 5)
+                    this->push_digits(1, 0, true);
+            }
+
+            T result()
+            {
+                // missing fractional digits count as zeros
+                this->push_digits(0, fraction_digits - m_fraction_count, true);
+
+                if (m_negative)
+                    return static_cast<T>(0 - m_magnitude);
+
+                return static_cast<T>(m_magnitude);
+            }
+
+            magnitude_type m_magnitude = 0;
+            int m_fraction_count = 0;
+            bool m_negative = false;
+
+        };
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // 'read_fixed_point' overloads
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // Reads a decimal number as multiple of 1 / Scale. Throws unexpected_input if the number is
+    // malformed, with the source positioned at the offending character, and value_out_of_range if
+    // it doesn't fit into T, with the source positioned somewhere within the number.
+    template <
+        typename T,
+        T Scale,
+        rounding R = rounding::truncate,
+        typename I,
+        typename = requires_t<is_input_source_type<I>>
+    >
+    T read_fixed_point(I& ins)
+    {
+        using reader = detail::fixed_point_reader<T, Scale, R>;
+
+        if constexpr (is_contiguous_input_source_type_v<I>)
+        {
+            using traits = input_source_traits<I>;
+
+            std::size_t count = 0;
+
+            try
+            {
+                const auto value = reader::read(traits::data(ins), traits::size(ins), count);
+
+                traits::advance(ins, count);
+
+                return value;
+            }
+            catch (const unexpected_input&)
+            {
+                traits::advance(ins, count);
+                throw;
+            }
+        }
+        else
+        {
+            return reader::read(ins, nullptr);
+        }
+    }
+
+    template <
+        typename T,
+        T Scale,
+        rounding R = rounding::truncate,
+        typename I,
+        typename = requires_t<is_input_source_type<I>>
+    >
+    T read_fixed_point(I& ins, code_position& pos)
+    {
+        using reader = detail::fixed_point_reader<T, Scale, R>;
+
+        if constexpr (is_contiguous_input_source_type_v<I>)
+        {
+            using traits = input_source_traits<I>;
+            using view_type = std::basic_string_view<typename traits::char_type>;
+
+            const auto first = traits::data(ins);
+
+            std::size_t count = 0;
+
+            try
+            {
+                const auto value = reader::read(first, traits::size(ins), count);
+
+                pos.advance_columns(view_type{ first, count });
+                traits::advance(ins, count);
+
+                return value;
+            }
+            catch (const unexpected_input&)
+            {
+                pos.advance_columns(view_type{ first, count });
+                traits::advance(ins, count);
+                throw;
+            }
+        }
+        else
+        {
+            return reader::read(ins, &pos);
+        }
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // bound fixed point consumers
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    template <typename T, T Scale, rounding R>
+    struct bound_fixed_point_read
+    {
+
+        template <typename I>
+        T operator()(I& ins) const
+        {
+            return read_fixed_point<T, Scale, R>(ins);
+        }
+
+        template <typename I>
+        T operator()(I& ins, code_position& pos) const
+        {
+            return read_fixed_point<T, Scale, R>(ins, pos);
+        }
+
+    };
+
+    template <typename T, T Scale, rounding R = rounding::truncate>
+    constexpr auto read_fixed_point()
+    {
+        return bound_fixed_point_read<T, Scale, R>{ };
+    }
+
+}
+
+
+#endif /*__FIXED_POINT_HPP__*/
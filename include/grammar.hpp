@@ -0,0 +1,665 @@
+#ifndef __GRAMMAR_HPP__
+#define __GRAMMAR_HPP__
+
+
+// Grammars are composed from bound predicates in EBNF style. Every composition computes its FIRST
+// set at construction, which makes LL(1) conflicts detectable at compile time and allows
+// alternatives to be dispatched by a single table lookup instead of testing them in order.
+// Recursive rules are not supported and have to be expressed as repetitions.
+//
+//   constexpr auto number  = whirl::sequence(whirl::option(whirl::negative_sign),
+//                                            whirl::repetition(whirl::digit));
+//   constexpr auto grammar = whirl::sequence(number, whirl::end);
+//
+//   static_assert(whirl::is_ll1(grammar), "grammar is not LL(1)");
+
+
+#include <array>
+#include <tuple>
+#include <utility>
+
+#include "whirl.hpp"
+#include "character_set.hpp"
+
+
+namespace whirl
+{
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // grammar symbol type traits
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    template <typename P>
+    struct terminal_symbol;
+
+    template <typename... Gs>
+    struct sequence_symbol;
+
+    template <typename... Gs>
+    struct alternative_symbol;
+
+    template <typename G>
+    struct option_symbol;
+
+    template <typename G>
+    struct repetition_symbol;
+
+    template <typename T>
+    struct is_grammar_symbol : std::false_type
+    { };
+
+    template <typename P>
+    struct is_grammar_symbol<terminal_symbol<P>> : std::true_type
+    { };
+
+    template <typename... Gs>
+    struct is_grammar_symbol<sequence_symbol<Gs...>> : std::true_type
+    { };
+
+    template <typename... Gs>
+    struct is_grammar_symbol<alternative_symbol<Gs...>> : std::true_type
+    { };
+
+    template <typename G>
+    struct is_grammar_symbol<option_symbol<G>> : std::true_type
+    { };
+
+    template <typename G>
+    struct is_grammar_symbol<repetition_symbol<G>> : std::true_type
+    { };
+
+    template <typename T>
+    constexpr auto is_grammar_symbol_v = is_grammar_symbol<T>::value;
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // LL(1) conflicts
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    enum class ll1_conflict
+    {
+        none,
+        first_first,      // two alternatives start with the same character
+        first_follow,     // an optional part starts with a character that may also follow it
+        ambiguous_empty,  // more than one way to derive the empty word
+        empty_repetition  // a repetition whose body may derive the empty word
+    };
+
+    namespace detail
+    {
+        constexpr ll1_conflict first_conflict(ll1_conflict lhs, ll1_conflict rhs) noexcept
+        {
+            return lhs != ll1_conflict::none ? lhs : rhs;
+        }
+
+        // Tests the look ahead against the FIRST set of a symbol. Characters beyond the domain of
+        // character_set, and the upper half of it for sources not reading chars, are decided by
+        // the original predicates.
+        template <typename G, typename I>
+        constexpr bool accepts(const G& sym, I& ins)
+        {
+            using char_type = typename input_source_traits<I>::char_type;
+
+            if (input_source_traits<I>::is_end(ins))
+                return sym.first.contains_end();
+
+            const auto unit = code_unit(input_source_traits<I>::look_ahead(ins));
+            const auto limit = std::is_same_v<char_type, char> ? character_set::domain_size : 128;
+
+            if (unit < limit)
+                return sym.first.contains(unit);
+
+            return sym.starts(ins);
+        }
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // grammar symbols
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // Reads exactly one character satisfying the predicate. The predefined end predicate is the
+    // only terminal that doesn't consume anything.
+    template <typename P>
+    struct terminal_symbol
+    {
+
+        static_assert(is_bound_predicate_v<P>);
+
+
+        explicit constexpr terminal_symbol(const P& pred)
+            : pred{ pred }
+            , first{ first_of(pred) }
+            , nullable{ false }
+        { }
+
+        template <typename I>
+        constexpr bool starts(I& ins) const
+        {
+            return this->pred.is(ins);
+        }
+
+        constexpr ll1_conflict check(const character_set&) const noexcept
+        {
+            return ll1_conflict::none;
+        }
+
+        template <typename I>
+        constexpr void operator()(I& ins) const
+        {
+            code_position pos{ };
+
+            (*this)(ins, pos);
+        }
+
+        template <typename I>
+        constexpr void operator()(I& ins, code_position& pos) const
+        {
+            if (!this->pred.is(ins))
+                throw unexpected_input{};
+
+            if constexpr (!std::is_same_v<P, bound_is_end_predicate>)
+                next(ins, pos);
+        }
+
+        P pred;
+        character_set first;
+        bool nullable;
+
+    private:
+
+        static constexpr character_set first_of(const P& pred)
+        {
+            if constexpr (std::is_same_v<P, bound_is_end_predicate>)
+            {
+                return character_set::end();
+            }
+            else
+            {
+                auto set = character_set::of(pred);
+
+                set.erase_end();
+
+                return set;
+            }
+        }
+
+    };
+
+    template <typename... Gs>
+    struct sequence_symbol
+    {
+
+        static_assert((is_grammar_symbol_v<Gs> && ...));
+        static_assert(sizeof...(Gs) > 0);
+
+
+        explicit constexpr sequence_symbol(const Gs&... syms)
+            : syms{ syms... }
+            , first{ first_of(syms...) }
+            , nullable{ (syms.nullable && ...) }
+        { }
+
+        template <typename I>
+        constexpr bool starts(I& ins) const
+        {
+            return starts_impl<0>(ins);
+        }
+
+        constexpr ll1_conflict check(const character_set& follow) const
+        {
+            std::array<character_set, sizeof...(Gs)> follows{ };
+            std::array<character_set, sizeof...(Gs)> firsts{ };
+            std::array<bool, sizeof...(Gs)> nullables{ };
+
+            std::apply(
+                [&](const auto&... syms) {
+                    std::size_t idx = 0;
+                    ((firsts[idx] = syms.first, nullables[idx++] = syms.nullable), ...);
+                },
+                this->syms
+            );
+
+            auto tail = follow;
+
+            for (std::size_t idx = sizeof...(Gs); idx-- > 0;)
+            {
+                follows[idx] = tail;
+                tail = nullables[idx] ? firsts[idx] | tail : firsts[idx];
+            }
+
+            return std::apply(
+                [&follows](const auto&... syms) {
+                    std::size_t idx = 0;
+                    auto conflict = ll1_conflict::none;
+
+                    ((conflict = detail::first_conflict(
+                        conflict, syms.check(follows[idx++]))), ...);
+
+                    return conflict;
+                },
+                this->syms
+            );
+        }
+
+        template <typename I>
+        constexpr void operator()(I& ins) const
+        {
+            code_position pos{ };
+
+            (*this)(ins, pos);
+        }
+
+        template <typename I>
+        constexpr void operator()(I& ins, code_position& pos) const
+        {
+            std::apply([&](const auto&... syms) { (syms(ins, pos), ...); }, this->syms);
+        }
+
+        std::tuple<Gs...> syms;
+        character_set first;
+        bool nullable;
+
+    private:
+
+        static constexpr character_set first_of(const Gs&... syms)
+        {
+            character_set set;
+            bool reachable = true;
+
+            ((reachable ? (set |= syms.first, reachable = syms.nullable) : false), ...);
+
+            return set;
+        }
+
+        template <std::size_t N, typename I>
+        constexpr bool starts_impl(I& ins) const
+        {
+            if constexpr (N == sizeof...(Gs))
+            {
+                return false;
+            }
+            else
+            {
+                const auto& sym = std::get<N>(this->syms);
+
+                return detail::accepts(sym, ins) || (sym.nullable && starts_impl<N + 1>(ins));
+            }
+        }
+
+    };
+
+    template <typename... Gs>
+    struct alternative_symbol
+    {
+
+        static_assert((is_grammar_symbol_v<Gs> && ...));
+        static_assert(sizeof...(Gs) > 0 && sizeof...(Gs) < 255);
+
+
+        static constexpr unsigned char no_alternative = 255;
+
+
+        explicit constexpr alternative_symbol(const Gs&... syms)
+            : syms{ syms... }
+            , first{ (syms.first | ...) }
+            , nullable{ (syms.nullable || ...) }
+            , table{ table_of(syms...) }
+        { }
+
+        template <typename I>
+        constexpr bool starts(I& ins) const
+        {
+            return std::apply(
+                [&ins](const auto&... syms) { return (detail::accepts(syms, ins) || ...); },
+                this->syms
+            );
+        }
+
+        constexpr ll1_conflict check(const character_set& follow) const
+        {
+            std::array<character_set, sizeof...(Gs)> firsts{ };
+            std::size_t nullables = 0;
+
+            std::apply(
+                [&](const auto&... syms) {
+                    std::size_t idx = 0;
+                    ((firsts[idx++] = syms.first, nullables += syms.nullable), ...);
+                },
+                this->syms
+            );
+
+            for (std::size_t lhs = 0; lhs < firsts.size(); ++lhs)
+            {
+                for (std::size_t rhs = lhs + 1; rhs < firsts.size(); ++rhs)
+                {
+                    if (firsts[lhs].intersects(firsts[rhs]))
+                        return ll1_conflict::first_first;
+                }
+            }
+
+            if (nullables > 1)
+                return ll1_conflict::ambiguous_empty;
+
+            if (nullables == 1 && this->first.intersects(follow))
+                return ll1_conflict::first_follow;
+
+            return std::apply(
+                [&follow](const auto&... syms) {
+                    auto conflict = ll1_conflict::none;
+
+                    ((conflict = detail::first_conflict(conflict, syms.check(follow))), ...);
+
+                    return conflict;
+                },
+                this->syms
+            );
+        }
+
+        template <typename I>
+        constexpr void operator()(I& ins) const
+        {
+            code_position pos{ };
+
+            (*this)(ins, pos);
+        }
+
+        template <typename I>
+        constexpr void operator()(I& ins, code_position& pos) const
+        {
+            const auto idx = this->select(ins);
+
+            if (idx == no_alternative)
+                throw unexpected_input{};
+
+            handlers<I>[idx](*this, ins, pos);
+        }
+
+        std::tuple<Gs...> syms;
+        character_set first;
+        bool nullable;
+
+        // index of the alternative to take for every code unit and the end token
+        std::array<unsigned char, character_set::domain_size + 1> table;
+
+    private:
+
+        using index_sequence_type = std::index_sequence_for<Gs...>;
+
+        template <std::size_t N, typename I>
+        static constexpr void invoke(const alternative_symbol& alt, I& ins, code_position& pos)
+        {
+            std::get<N>(alt.syms)(ins, pos);
+        }
+
+        template <typename I, std::size_t... Ns>
+        static constexpr auto handlers_of(std::index_sequence<Ns...>)
+        {
+            using handler_type = void (*)(const alternative_symbol&, I&, code_position&);
+
+            return std::array<handler_type, sizeof...(Gs)>{ &invoke<Ns, I>... };
+        }
+
+        template <typename I>
+        static constexpr auto handlers = handlers_of<I>(index_sequence_type{});
+
+        static constexpr auto table_of(const Gs&... syms)
+        {
+            std::array<unsigned char, character_set::domain_size + 1> table{ };
+            auto fallback = no_alternative;
+
+            for (auto& idx : table)
+                idx = no_alternative;
+
+            unsigned char alt = 0;
+
+            ((fill(table, syms.first, alt),
+              fallback = (syms.nullable && fallback == no_alternative) ? alt : fallback,
+              ++alt), ...);
+
+            for (auto& idx : table)
+                idx = idx == no_alternative ? fallback : idx;
+
+            return table;
+        }
+
+        static constexpr void fill(
+            std::array<unsigned char, character_set::domain_size + 1>& table,
+            const character_set& first,
+            unsigned char alt)
+        {
+            for (std::size_t idx = 0; idx < table.size(); ++idx)
+            {
+                if (first.contains(idx) && table[idx] == no_alternative)
+                    table[idx] = alt;
+            }
+        }
+
+        template <typename I>
+        constexpr unsigned char select(I& ins) const
+        {
+            using char_type = typename input_source_traits<I>::char_type;
+
+            if (input_source_traits<I>::is_end(ins))
+                return this->table[character_set::end_index];
+
+            const auto unit = code_unit(input_source_traits<I>::look_ahead(ins));
+            const auto limit = std::is_same_v<char_type, char> ? character_set::domain_size : 128;
+
+            if (unit < limit)
+                return this->table[unit];
+
+            return select_impl<0>(ins);
+        }
+
+        template <std::size_t N, typename I>
+        constexpr unsigned char select_impl(I& ins) const
+        {
+            if constexpr (N == sizeof...(Gs))
+            {
+                return this->fallback_index();
+            }
+            else
+            {
+                return std::get<N>(this->syms).starts(ins) ?
+                    static_cast<unsigned char>(N) : select_impl<N + 1>(ins);
+            }
+        }
+
+        constexpr unsigned char fallback_index() const
+        {
+            unsigned char idx = 0;
+            auto fallback = no_alternative;
+
+            std::apply(
+                [&](const auto&... syms) {
+                    ((fallback = (syms.nullable && fallback == no_alternative) ? idx : fallback,
+                      ++idx), ...);
+                },
+                this->syms
+            );
+
+            return fallback;
+        }
+
+    };
+
+    template <typename G>
+    struct option_symbol
+    {
+
+        static_assert(is_grammar_symbol_v<G>);
+
+
+        explicit constexpr option_symbol(const G& sym)
+            : sym{ sym }
+            , first{ sym.first }
+            , nullable{ true }
+        { }
+
+        template <typename I>
+        constexpr bool starts(I& ins) const
+        {
+            return this->sym.starts(ins);
+        }
+
+        constexpr ll1_conflict check(const character_set& follow) const
+        {
+            if (this->sym.nullable)
+                return ll1_conflict::ambiguous_empty;
+
+            if (this->first.intersects(follow))
+                return ll1_conflict::first_follow;
+
+            return this->sym.check(follow);
+        }
+
+        template <typename I>
+        constexpr void operator()(I& ins) const
+        {
+            code_position pos{ };
+
+            (*this)(ins, pos);
+        }
+
+        template <typename I>
+        constexpr void operator()(I& ins, code_position& pos) const
+        {
+            if (detail::accepts(this->sym, ins))
+                this->sym(ins, pos);
+        }
+
+        G sym;
+        character_set first;
+        bool nullable;
+
+    };
+
+    template <typename G>
+    struct repetition_symbol
+    {
+
+        static_assert(is_grammar_symbol_v<G>);
+
+
+        explicit constexpr repetition_symbol(const G& sym)
+            : sym{ sym }
+            , first{ sym.first }
+            , nullable{ true }
+        { }
+
+        template <typename I>
+        constexpr bool starts(I& ins) const
+        {
+            return this->sym.starts(ins);
+        }
+
+        constexpr ll1_conflict check(const character_set& follow) const
+        {
+            if (this->sym.nullable || this->first.contains_end())
+                return ll1_conflict::empty_repetition;
+
+            if (this->first.intersects(follow))
+                return ll1_conflict::first_follow;
+
+            return this->sym.check(this->first | follow);
+        }
+
+        template <typename I>
+        constexpr void operator()(I& ins) const
+        {
+            code_position pos{ };
+
+            (*this)(ins, pos);
+        }
+
+        template <typename I>
+        constexpr void operator()(I& ins, code_position& pos) const
+        {
+            while (detail::accepts(this->sym, ins))
+                this->sym(ins, pos);
+        }
+
+        G sym;
+        character_set first;
+        bool nullable;
+
+    };
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // grammar symbol factories
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    template <typename T, typename = requires_t<is_bound_predicate<T>>>
+    constexpr auto symbol(const T& pred)
+    {
+        return terminal_symbol{ pred };
+    }
+
+    template <typename T, typename = requires_t<is_grammar_symbol<T>>, typename = void>
+    constexpr auto symbol(const T& sym)
+    {
+        return sym;
+    }
+
+    template <typename... Ts>
+    constexpr auto sequence(const Ts&... syms)
+    {
+        return sequence_symbol{ symbol(syms)... };
+    }
+
+    template <typename... Ts>
+    constexpr auto alternative(const Ts&... syms)
+    {
+        return alternative_symbol{ symbol(syms)... };
+    }
+
+    template <typename T>
+    constexpr auto option(const T& sym)
+    {
+        return option_symbol{ symbol(sym) };
+    }
+
+    template <typename T>
+    constexpr auto repetition(const T& sym)
+    {
+        return repetition_symbol{ symbol(sym) };
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // grammar analysis
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    template <typename T>
+    constexpr character_set first_set(const T& sym)
+    {
+        return symbol(sym).first;
+    }
+
+    template <typename T>
+    constexpr bool is_nullable(const T& sym)
+    {
+        return symbol(sym).nullable;
+    }
+
+    // The FOLLOW sets of all nested symbols are derived from the FOLLOW set of the whole grammar,
+    // which is the end token only, if the grammar describes the complete input.
+    template <typename T>
+    constexpr ll1_conflict find_ll1_conflict(
+        const T& sym, const character_set& follow = character_set::end())
+    {
+        return symbol(sym).check(follow);
+    }
+
+    template <typename T>
+    constexpr bool is_ll1(const T& sym, const character_set& follow = character_set::end())
+    {
+        return find_ll1_conflict(sym, follow) == ll1_conflict::none;
+    }
+
+}
+
+
+#endif /*__GRAMMAR_HPP__*/
@@ -0,0 +1,391 @@
+#ifndef __ISO8601_HPP__
+#define __ISO8601_HPP__
+
+
+// Timestamps in the ISO 8601 layout YYYY-MM-DDThh:mm:ss[.fff][Z|+hh:mm|-hh:mm], read as points in
+// time of the system clock with a resolution of nanoseconds.
+//
+//   const auto time = whirl::read_iso8601(ins);
+//
+// Fractions of seconds have at least one digit, of which the ones beyond nanoseconds are
+// truncated. Timestamps without a time zone are taken as UTC. On contiguous char sources the
+// fixed width date and time are validated and converted within 64 bit words, if enough characters
+// are available.
+
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string_view>
+
+#include "whirl.hpp"
+#include "fixed_point.hpp"
+
+
+namespace whirl
+{
+
+    using iso8601_time =
+        std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds>;
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // timestamp conversion
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    namespace detail
+    {
+        struct iso8601_fields
+        {
+            int year = 0;
+            int month = 0;
+            int day = 0;
+            int hour = 0;
+            int minute = 0;
+            int second = 0;
+            std::int64_t nanoseconds = 0;
+            int offset_minutes = 0;
+        };
+
+        // The number of days since 1970-01-01 of a date in the proleptic Gregorian calendar, from
+        // year 0 on. The year is shifted by a cycle of 400 years, so all divisions are unsigned.
+        constexpr std::int64_t days_from_civil(int year, int month, int day) noexcept
+        {
+            constexpr std::uint32_t days_per_cycle = 146097;
+            constexpr std::uint32_t days_before_epoch = 719468;
+
+            // the years start in March, hence leap days are at their end
+            const auto shifted_year = static_cast<std::uint32_t>(year + 400 - (month <= 2));
+            const auto shifted_month = static_cast<std::uint32_t>(
+                month > 2 ? month - 3 : month + 9);
+            const auto day_of_year =
+                (153 * shifted_month + 2) / 5 + static_cast<std::uint32_t>(day) - 1;
+            const auto days = shifted_year * 365 + shifted_year / 4 - shifted_year / 100
+                + shifted_year / 400 + day_of_year;
+
+            return static_cast<std::int64_t>(days) - days_per_cycle - days_before_epoch;
+        }
+
+        constexpr int days_in_month(int year, int month) noexcept
+        {
+            constexpr int days[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+            const auto leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+
+            return month == 2 && leap ? 29 : days[month - 1];
+        }
+
+        // Validates the ranges of the fields and converts them. Throws unexpected_input for an
+        // invalid date or time, and value_out_of_range beyond the range of the time point.
+        inline iso8601_time to_time_point(const iso8601_fields& fields)
+        {
+            if (fields.month < 1 || fields.month > 12
+                || fields.day < 1 || fields.day > days_in_month(fields.year, fields.month)
+                || fields.hour > 23 || fields.minute > 59 || fields.second > 59)
+            {
+                throw unexpected_input{ };
+            }
+
+            const auto seconds = days_from_civil(fields.year, fields.month, fields.day) * 86400
+                + fields.hour * 3600 + fields.minute * 60 + fields.second
+                - fields.offset_minutes * 60;
+
+            constexpr std::int64_t nano = 1000000000;
+            constexpr auto max = std::numeric_limits<std::int64_t>::max();
+            constexpr auto min = std::numeric_limits<std::int64_t>::min();
+
+            // before 1970 the nanoseconds borrow a second, lest the seconds overflow on their own
+            if (seconds < 0)
+            {
+                const auto borrowed = nano - fields.nanoseconds;
+
+                if (seconds + 1 < (min + borrowed) / nano)
+                    throw value_out_of_range{ };
+
+                return iso8601_time{ std::chrono::nanoseconds{ (seconds + 1) * nano - borrowed } };
+            }
+
+            if (seconds > (max - fields.nanoseconds) / nano)
+                throw value_out_of_range{ };
+
+            return iso8601_time{ std::chrono::nanoseconds{ seconds * nano + fields.nanoseconds } };
+        }
+
+        // Reads exactly count digits.
+        template <typename I>
+        int read_iso8601_digits(I& ins, code_position* pos, int count)
+        {
+            using traits = input_source_traits<I>;
+            using char_type = typename traits::char_type;
+
+            int value = 0;
+
+            for (; count > 0; --count)
+            {
+                if (traits::is_end(ins))
+                    throw unexpected_input{ };
+
+                const auto chr = traits::look_ahead(ins);
+
+                if (chr < char_type('0') || chr > char_type('9'))
+                    throw unexpected_input{ };
+
+                value = value * 10 + static_cast<int>(chr - char_type('0'));
+                pos ? next(ins, *pos) : next(ins);
+            }
+
+            return value;
+        }
+
+        template <typename I>
+        void read_iso8601_separator(I& ins, code_position* pos, char separator)
+        {
+            using traits = input_source_traits<I>;
+            using char_type = typename traits::char_type;
+
+            if (traits::is_end(ins) || traits::look_ahead(ins) != char_type(separator))
+                throw unexpected_input{ };
+
+            pos ? next(ins, *pos) : next(ins);
+        }
+
+        template <typename I>
+        void read_iso8601_date_time(I& ins, code_position* pos, iso8601_fields& fields)
+        {
+            fields.year = read_iso8601_digits(ins, pos, 4);
+            read_iso8601_separator(ins, pos, '-');
+            fields.month = read_iso8601_digits(ins, pos, 2);
+            read_iso8601_separator(ins, pos, '-');
+            fields.day = read_iso8601_digits(ins, pos, 2);
+            read_iso8601_separator(ins, pos, 'T');
+            fields.hour = read_iso8601_digits(ins, pos, 2);
+            read_iso8601_separator(ins, pos, ':');
+            fields.minute = read_iso8601_digits(ins, pos, 2);
+            read_iso8601_separator(ins, pos, ':');
+            fields.second = read_iso8601_digits(ins, pos, 2);
+        }
+
+        // Reads the optional fraction of a second and time zone.
+        template <typename I>
+        void read_iso8601_suffix(I& ins, code_position* pos, iso8601_fields& fields)
+        {
+            using traits = input_source_traits<I>;
+            using char_type = typename traits::char_type;
+
+            const auto is_next = [&ins](char chr) {
+                return !traits::is_end(ins) && traits::look_ahead(ins) == char_type(chr);
+            };
+
+            const auto is_digit_next = [&ins]() {
+                return !traits::is_end(ins) && traits::look_ahead(ins) >= char_type('0')
+                    && traits::look_ahead(ins) <= char_type('9');
+            };
+
+            if (is_next('.'))
+            {
+                pos ? next(ins, *pos) : next(ins);
+
+                if (!is_digit_next())
+                    throw unexpected_input{ };
+
+                constexpr int max_digits = 9;
+
+                int digits = 0;
+
+                for (; is_digit_next(); pos ? next(ins, *pos) : next(ins))
+                {
+                    if (digits < max_digits)
+                    {
+                        fields.nanoseconds = fields.nanoseconds * 10
+                            + (traits::look_ahead(ins) - char_type('0'));
+                        ++digits;
+                    }
+                }
+
+                for (; digits < max_digits; ++digits)
+                    fields.nanoseconds *= 10;
+            }
+
+            if (is_next('Z'))
+            {
+                pos ? next(ins, *pos) : next(ins);
+            }
+            else if (is_next('+') || is_next('-'))
+            {
+                const auto sign = traits::look_ahead(ins) == char_type('-') ? -1 : 1;
+
+                pos ? next(ins, *pos) : next(ins);
+
+                const auto hours = read_iso8601_digits(ins, pos, 2);
+                read_iso8601_separator(ins, pos, ':');
+                const auto minutes = read_iso8601_digits(ins, pos, 2);
+
+                if (hours > 23 || minutes > 59)
+                    throw unexpected_input{ };
+
+                fields.offset_minutes = sign * (hours * 60 + minutes);
+            }
+        }
+
+    #if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        // Checks eight characters, stored little endian in a word, against a layout of digits,
+        // marked by a mask, and separators. On success each digit is replaced by the value of the
+        // two digit number starting at it.
+        inline bool convert_iso8601_word(
+            std::uint64_t chars, std::uint64_t layout, std::uint64_t digit_mask,
+            std::uint64_t& pairs) noexcept
+        {
+            constexpr std::uint64_t zeros = 0x3030303030303030;
+
+            if ((chars & ~digit_mask) != (layout & ~digit_mask))
+                return false;
+
+            // the separators are replaced by zeros, which don't disturb the digit test
+            const auto digits = (chars & digit_mask) | (zeros & ~digit_mask);
+            const auto non_digits = ((digits & 0xF0F0F0F0F0F0F0F0) - zeros)
+                | (((digits + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) - zeros);
+
+            if (non_digits != 0)
+                return false;
+
+            const auto values = digits - zeros;
+
+            pairs = values * 10 + (values >> 8);
+
+            return true;
+        }
+
+        // Reads the date and time from 19 characters at once, if they're well formed.
+        inline bool convert_iso8601_date_time(const char* first, iso8601_fields& fields) noexcept
+        {
+            std::uint64_t date;
+            std::uint64_t day_time;
+            std::uint64_t time;
+
+            // "YYYY-MM-", "DDThh:mm" and the overlapping "hh:mm:ss"
+            std::memcpy(&date, first, 8);
+            std::memcpy(&day_time, first + 8, 8);
+            std::memcpy(&time, first + 11, 8);
+
+            std::uint64_t date_pairs;
+            std::uint64_t day_time_pairs;
+            std::uint64_t time_pairs;
+
+            if (!convert_iso8601_word(date, 0x2D30302D30303030, 0x00FFFF00FFFFFFFF, date_pairs)
+                || !convert_iso8601_word(
+                    day_time, 0x30303A3030543030, 0xFFFF00FFFF00FFFF, day_time_pairs)
+                || !convert_iso8601_word(time, 0x30303A30303A3030, 0xFFFF00FFFF00FFFF, time_pairs))
+            {
+                return false;
+            }
+
+            const auto pair = [](std::uint64_t pairs, int idx) {
+                return static_cast<int>((pairs >> (8 * idx)) & 0xFF);
+            };
+
+            fields.year = pair(date_pairs, 0) * 100 + pair(date_pairs, 2);
+            fields.month = pair(date_pairs, 5);
+            fields.day = pair(day_time_pairs, 0);
+            fields.hour = pair(day_time_pairs, 3);
+            fields.minute = pair(day_time_pairs, 6);
+            fields.second = pair(time_pairs, 6);
+
+            return true;
+        }
+    #endif
+
+        template <typename I>
+        iso8601_time read_iso8601(I& ins, code_position* pos)
+        {
+            using traits = input_source_traits<I>;
+            using char_type = typename traits::char_type;
+
+            iso8601_fields fields;
+
+            auto converted = false;
+
+        #if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+            if constexpr (is_contiguous_input_source_type_v<I> && sizeof(char_type) == 1)
+            {
+                using view_type = std::basic_string_view<char_type>;
+
+                constexpr std::size_t date_time_size = 19;
+
+                const auto first = traits::data(ins);
+
+                if (traits::size(ins) >= date_time_size && convert_iso8601_date_time(
+                    reinterpret_cast<const char*>(first), fields))
+                {
+                    if (pos)
+                        pos->advance_columns(view_type{ first, date_time_size });
+
+                    traits::advance(ins, date_time_size);
+                    converted = true;
+                }
+            }
+        #endif
+
+            // malformed timestamps are read character by character as well, to find the error
+            if (!converted)
+                read_iso8601_date_time(ins, pos, fields);
+
+            read_iso8601_suffix(ins, pos, fields);
+
+            return to_time_point(fields);
+        }
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // 'read_iso8601' overloads
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // Reads a timestamp. Throws unexpected_input if it's malformed, with the source positioned at
+    // the offending character, or if the date or time is invalid, e.g. February 30th, with the
+    // source positioned after the timestamp. Throws value_out_of_range for a timestamp beyond the
+    // range of nanoseconds since 1970, i.e. before 1677 or after 2262.
+    template <typename I, typename = requires_t<is_input_source_type<I>>>
+    iso8601_time read_iso8601(I& ins)
+    {
+        return detail::read_iso8601(ins, nullptr);
+    }
+
+    template <typename I, typename = requires_t<is_input_source_type<I>>>
+    iso8601_time read_iso8601(I& ins, code_position& pos)
+    {
+        return detail::read_iso8601(ins, &pos);
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // bound timestamp consumers
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    struct bound_iso8601_read
+    {
+
+        template <typename I>
+        iso8601_time operator()(I& ins) const
+        {
+            return read_iso8601(ins);
+        }
+
+        template <typename I>
+        iso8601_time operator()(I& ins, code_position& pos) const
+        {
+            return read_iso8601(ins, pos);
+        }
+
+    };
+
+    constexpr auto read_iso8601()
+    {
+        return bound_iso8601_read{ };
+    }
+
+}
+
+
+#endif /*__ISO8601_HPP__*/
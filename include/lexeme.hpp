@@ -0,0 +1,219 @@
+#ifndef __LEXEME_HPP__
+#define __LEXEME_HPP__
+
+
+// Raw lexemes, e.g. identifiers or unit names, without building a string character by character.
+// On contiguous sources the characters matched are returned as a view into the source, on other
+// sources they are collected in a lexeme with a small inline buffer.
+//
+//   const auto digits = whirl::next_while_view(ins, whirl::digit);
+//   std::string_view text = digits;
+//
+// On contiguous char sources, a code unit class as predicate scans 64 characters at a time.
+
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "whirl.hpp"
+#include "scan.hpp"
+
+
+namespace whirl
+{
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // lexemes
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // A string keeping up to N characters inline, which covers most tokens without allocating.
+    template <typename C, std::size_t N = 32>
+    class basic_lexeme
+    {
+
+        static_assert(is_character_type_v<C>);
+
+    public:
+
+        using value_type = C;
+        using view_type = std::basic_string_view<C>;
+        using const_iterator = const C*;
+
+        static constexpr std::size_t inline_capacity = N;
+
+
+        void push_back(C chr)
+        {
+            if (m_size < N)
+            {
+                m_inline[m_size++] = chr;
+                return;
+            }
+
+            if (m_size == N)
+                m_overflow.assign(m_inline, N);
+
+            m_overflow.push_back(chr);
+            ++m_size;
+        }
+
+        const C* data() const noexcept
+        {
+            return m_size <= N ? m_inline : m_overflow.data();
+        }
+
+        std::size_t size() const noexcept
+        {
+            return m_size;
+        }
+
+        bool empty() const noexcept
+        {
+            return m_size == 0;
+        }
+
+        const_iterator begin() const noexcept
+        {
+            return this->data();
+        }
+
+        const_iterator end() const noexcept
+        {
+            return this->data() + m_size;
+        }
+
+        view_type view() const noexcept
+        {
+            return view_type{ this->data(), m_size };
+        }
+
+        operator view_type() const noexcept
+        {
+            return this->view();
+        }
+
+    private:
+
+        C m_inline[N];
+        std::basic_string<C> m_overflow;
+        std::size_t m_size = 0;
+
+    };
+
+    // the result of next_while_view for a source type
+    template <typename I>
+    using lexeme_t = std::conditional_t<
+        is_contiguous_input_source_type_v<I>,
+        std::basic_string_view<typename input_source_traits<I>::char_type>,
+        basic_lexeme<typename input_source_traits<I>::char_type>
+    >;
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // 'next_while_view' overloads
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    template <
+        typename I,
+        typename P,
+        typename = requires_t<is_input_source_type<I>>,
+        typename = requires_t<is_bound_predicate<P>>
+    >
+    lexeme_t<I> next_while_view(I& ins, const P& pred)
+    {
+        using traits = input_source_traits<I>;
+
+        if constexpr (is_contiguous_input_source_type_v<I>)
+        {
+            const auto first = traits::data(ins);
+            const auto count = detail::match_length(first, traits::size(ins), pred);
+
+            traits::advance(ins, count);
+
+            return lexeme_t<I>{ first, count };
+        }
+        else
+        {
+            lexeme_t<I> result;
+
+            // as on contiguous sources, the end isn't part of a lexeme
+            while (!traits::is_end(ins) && pred.is(ins))
+                result.push_back(traits::read(ins));
+
+            return result;
+        }
+    }
+
+    template <
+        typename I,
+        typename P,
+        typename = requires_t<is_input_source_type<I>>,
+        typename = requires_t<is_bound_predicate<P>>
+    >
+    lexeme_t<I> next_while_view(I& ins, code_position& pos, const P& pred)
+    {
+        if constexpr (is_contiguous_input_source_type_v<I>)
+        {
+            const auto result = next_while_view(ins, pred);
+
+            detail::advance_over(pos, pred, result);
+
+            return result;
+        }
+        else
+        {
+            using traits = input_source_traits<I>;
+
+            lexeme_t<I> result;
+
+            while (!traits::is_end(ins) && pred.is(ins))
+                result.push_back(next(ins, pos, as_is));
+
+            return result;
+        }
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // bound lexeme consumers
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    template <typename P>
+    struct bound_conditional_multi_view_read
+    {
+
+        static_assert(is_bound_predicate_v<P>);
+
+
+        explicit constexpr bound_conditional_multi_view_read(const P& pred)
+            : pred{ pred }
+        { }
+
+        template <typename I>
+        auto operator()(I& ins) const
+        {
+            return next_while_view(ins, this->pred);
+        }
+
+        template <typename I>
+        auto operator()(I& ins, code_position& pos) const
+        {
+            return next_while_view(ins, pos, this->pred);
+        }
+
+        P pred;
+
+    };
+
+    template <typename P, typename = requires_t<is_bound_predicate<P>>>
+    constexpr auto next_while_view(const P& pred)
+    {
+        return bound_conditional_multi_view_read{ pred };
+    }
+
+}
+
+
+#endif /*__LEXEME_HPP__*/
@@ -0,0 +1,421 @@
+#ifndef __LEXER_HPP__
+#define __LEXER_HPP__
+
+
+// Lexers combine the patterns of several token kinds into one DFA at compile time and split the
+// input into tokens by maximal munch. If several kinds match the longest lexeme, the kind declared
+// first wins. The kinds are numbered in order of declaration.
+//
+//   constexpr auto number = whirl::token_kind{ 0 };
+//   constexpr auto comma  = whirl::token_kind{ 1 };
+//
+//   constexpr auto lexer = whirl::lexer("-?(0|[1-9][0-9]*)", whirl::is(','),
+//                                       whirl::skipped("[ \t\n]+"));
+//
+//   whirl::token_source tokens{ lexer, text };
+//
+//   whirl::next_is(tokens, whirl::is(number));
+//   whirl::next_is(tokens, whirl::is(comma));
+
+
+#include <array>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "whirl.hpp"
+#include "character_set.hpp"
+#include "regex.hpp"
+
+
+namespace whirl
+{
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // tokens
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // The kind of a token read by a lexer. Token sources use it as symbol type, so the predicates
+    // and consumers of the library work at token granularity.
+    enum class token_kind : unsigned char { };
+
+    template <>
+    struct is_symbol_type<token_kind> : std::true_type
+    { };
+
+    namespace detail
+    {
+        // token kinds have no stream type, hence predicates are probed with a character_probe
+        template <typename T>
+        struct is_bound_symbol_predicate_impl<T, requires_type_t<
+            decltype(std::declval<T>().is(std::declval<character_probe<token_kind>&>())), bool
+        >>
+            : std::true_type
+        {};
+    }
+
+    // look ahead of token sources at a lexeme not matched by any token kind
+    constexpr auto invalid_token = token_kind{ 254 };
+
+    // look ahead of token sources at the end of the input
+    constexpr auto end_of_tokens = token_kind{ 255 };
+
+    struct token
+    {
+        token_kind kind;
+        std::size_t offset;
+        std::size_t length;
+    };
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // token kind definitions
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // Either a regular expression or a set of single characters.
+    struct token_definition
+    {
+        const char* pattern;
+        std::size_t size;
+        character_set set;
+        bool skipped;
+    };
+
+    template <typename T>
+    struct skipped_token_kind
+    {
+        T kind;
+    };
+
+    namespace detail
+    {
+        template <std::size_t N>
+        constexpr token_definition make_token_definition(const char (&pattern)[N])
+        {
+            return token_definition{ pattern, N - 1, { }, false };
+        }
+
+        template <typename P, typename = requires_t<is_bound_predicate<P>>>
+        constexpr token_definition make_token_definition(const P& pred)
+        {
+            auto set = character_set::of(pred);
+
+            set.erase_end();
+
+            return token_definition{ nullptr, 0, set, false };
+        }
+
+        template <typename T>
+        constexpr token_definition make_token_definition(const skipped_token_kind<T>& skipped)
+        {
+            auto definition = make_token_definition(skipped.kind);
+
+            definition.skipped = true;
+
+            return definition;
+        }
+
+        template <typename T>
+        struct token_definition_size : std::integral_constant<std::size_t, 1>
+        { };
+
+        template <std::size_t N>
+        struct token_definition_size<char[N]> : std::integral_constant<std::size_t, N - 1>
+        { };
+
+        template <typename T>
+        struct token_definition_size<skipped_token_kind<T>>
+            : token_definition_size<std::remove_cv_t<std::remove_reference_t<T>>>
+        { };
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // compiled lexers
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    template <std::size_t S, std::size_t K, std::size_t T>
+    struct lexer_dfa
+    {
+
+        static_assert(T > 0 && T < 254);
+
+
+        using state_type = unsigned char;
+
+        static constexpr state_type dead_state = 0;
+        static constexpr unsigned char no_kind = 255;
+
+
+        constexpr state_type transition(state_type state, std::size_t unit) const noexcept
+        {
+            if (unit >= character_set::domain_size)
+                return dead_state;
+
+            return this->transitions[state * K + this->classes[unit]];
+        }
+
+        constexpr bool is_skipped(token_kind kind) const noexcept
+        {
+            return this->skipped[static_cast<std::size_t>(kind)];
+        }
+
+        // Matches the longest lexeme starting at offset. Returns an invalid token of length one if
+        // no token kind matches.
+        template <typename C>
+        constexpr token match(std::basic_string_view<C> text, std::size_t offset) const noexcept
+        {
+            auto state = this->start;
+            auto kind = no_kind;
+            std::size_t length = 0;
+
+            for (auto idx = offset; idx < text.size(); ++idx)
+            {
+                state = this->transition(state, code_unit(text[idx]));
+
+                if (state == dead_state)
+                    break;
+
+                if (this->kinds[state] != no_kind)
+                {
+                    kind = this->kinds[state];
+                    length = idx + 1 - offset;
+                }
+            }
+
+            if (kind == no_kind)
+                return token{ invalid_token, offset, 1 };
+
+            return token{ static_cast<token_kind>(kind), offset, length };
+        }
+
+        // Calls emit for every token, which isn't skipped, and throws unexpected_input at the first
+        // lexeme not matched by any token kind.
+        template <typename C, typename F>
+        constexpr void tokenize(std::basic_string_view<C> text, F&& emit) const
+        {
+            for (std::size_t offset = 0; offset < text.size();)
+            {
+                const auto tok = this->match(text, offset);
+
+                if (tok.kind == invalid_token)
+                    throw unexpected_input{};
+
+                if (!this->is_skipped(tok.kind))
+                    emit(tok);
+
+                offset += tok.length;
+            }
+        }
+
+        std::array<unsigned char, character_set::domain_size> classes;
+        std::array<state_type, S * K> transitions;
+        std::array<unsigned char, S> kinds;
+        std::array<bool, T> skipped;
+        std::size_t state_count;
+        std::size_t class_count;
+        state_type start;
+
+    };
+
+    namespace detail
+    {
+        template <std::size_t S, std::size_t K, std::size_t P, std::size_t T>
+        constexpr auto compile_lexer(const std::array<token_definition, T>& definitions)
+        {
+            using position_set = regex_position_set<P + 1>;
+
+            regex_parser<P> parser;
+            std::array<position_set, T> lasts{ };
+            position_set first;
+
+            for (std::size_t kind = 0; kind < T; ++kind)
+            {
+                const auto& definition = definitions[kind];
+
+                const auto frag = definition.pattern ?
+                    parser.parse(definition.pattern, definition.size) :
+                    parser.add(definition.set);
+
+                // an empty lexeme would never advance the input
+                if (frag.nullable)
+                    throw invalid_regex{};
+
+                lasts[kind] = frag.last;
+                first |= frag.first;
+            }
+
+            const auto tables = build_dfa<S, K>(parser, lasts, first);
+
+            lexer_dfa<S, K, T> lexer{ };
+
+            lexer.classes = tables.classes;
+            lexer.transitions = tables.transitions;
+            lexer.kinds = tables.tags;
+            lexer.state_count = tables.state_count;
+            lexer.class_count = tables.class_count;
+            lexer.start = tables.start;
+
+            for (std::size_t kind = 0; kind < T; ++kind)
+                lexer.skipped[kind] = definitions[kind].skipped;
+
+            return lexer;
+        }
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // lexer factories
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // Token kinds, which are matched but never emitted, e.g. whitespace or comments.
+    template <std::size_t N>
+    constexpr auto skipped(const char (&pattern)[N])
+    {
+        return skipped_token_kind<const char (&)[N]>{ pattern };
+    }
+
+    template <typename P, typename = requires_t<is_bound_predicate<P>>>
+    constexpr auto skipped(const P& pred)
+    {
+        return skipped_token_kind<P>{ pred };
+    }
+
+    // S is the maximum number of states of the minimized DFA and K the maximum number of byte
+    // classes.
+    template <std::size_t S, std::size_t K, typename... Ts>
+    constexpr auto lexer(const Ts&... kinds)
+    {
+        constexpr auto size = (detail::token_definition_size<std::remove_cv_t<
+            std::remove_reference_t<Ts>>>::value + ...);
+
+        return detail::compile_lexer<S, K, 4 * size + sizeof...(Ts)>(
+            std::array<token_definition, sizeof...(Ts)>{
+                detail::make_token_definition(kinds)...
+            }
+        );
+    }
+
+    template <typename... Ts>
+    constexpr auto lexer(const Ts&... kinds)
+    {
+        constexpr auto size = (detail::token_definition_size<std::remove_cv_t<
+            std::remove_reference_t<Ts>>>::value + ...);
+
+        constexpr auto capacity = detail::default_regex_capacity(size + sizeof...(Ts));
+
+        return lexer<capacity, capacity>(kinds...);
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // token sources
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // An input source of token kinds. Tokens are matched lazily, one token ahead of the consumer,
+    // and skipped token kinds are dropped.
+    template <typename L, typename C = char>
+    class token_source
+    {
+
+    public:
+
+        using view_type = std::basic_string_view<C>;
+
+
+        constexpr token_source(const L& lexer, view_type text) noexcept
+            : m_lexer{ &lexer }
+            , m_text{ text }
+            , m_current{ end_of_tokens, 0, 0 }
+        {
+            this->scan(0);
+        }
+
+        // the lexer is referred to, hence it has to outlive the source
+        token_source(const L&&, view_type) = delete;
+
+        // the look ahead token
+        constexpr const token& current() const noexcept
+        {
+            return m_current;
+        }
+
+        constexpr view_type lexeme() const noexcept
+        {
+            return m_text.substr(m_current.offset, m_current.length);
+        }
+
+        constexpr bool at_end() const noexcept
+        {
+            return m_current.kind == end_of_tokens;
+        }
+
+        constexpr void advance() noexcept
+        {
+            if (!this->at_end())
+                this->scan(m_current.offset + m_current.length);
+        }
+
+    private:
+
+        constexpr void scan(std::size_t offset) noexcept
+        {
+            while (offset < m_text.size())
+            {
+                m_current = m_lexer->match(m_text, offset);
+
+                if (m_current.kind == invalid_token || !m_lexer->is_skipped(m_current.kind))
+                    return;
+
+                offset += m_current.length;
+            }
+
+            m_current = token{ end_of_tokens, m_text.size(), 0 };
+        }
+
+        const L* m_lexer;
+        view_type m_text;
+        token m_current;
+
+    };
+
+    template <typename L, typename C>
+    token_source(const L&, std::basic_string_view<C>) -> token_source<L, C>;
+
+    template <typename L, typename C>
+    token_source(const L&, const C*) -> token_source<L, C>;
+
+    template <typename L, typename C>
+    struct input_source_traits<token_source<L, C>>
+    {
+        using char_type = token_kind;
+
+        static constexpr char_type look_ahead(token_source<L, C>& ins) noexcept
+        {
+            return ins.current().kind;
+        }
+
+        static constexpr char_type read(token_source<L, C>& ins) noexcept
+        {
+            const auto kind = ins.current().kind;
+
+            ins.advance();
+
+            return kind;
+        }
+
+        static constexpr void ignore(token_source<L, C>& ins) noexcept
+        {
+            ins.advance();
+        }
+
+        static constexpr bool is_end(token_source<L, C>& ins) noexcept
+        {
+            return ins.at_end();
+        }
+    };
+
+}
+
+
+#endif /*__LEXER_HPP__*/
@@ -0,0 +1,130 @@
+#ifndef __MAPPED_FILE_HPP__
+#define __MAPPED_FILE_HPP__
+
+
+// Read-only files as contiguous buffers. On POSIX systems the file is mapped into memory, on other
+// systems it is read into a buffer at once.
+
+
+#include <cerrno>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #define WHIRL_HAS_MMAP 1
+#else
+    #include <fstream>
+    #include <iterator>
+#endif
+
+
+namespace whirl
+{
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // mapped files
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // Throws std::system_error if the file can't be opened or mapped. The view is valid as long as
+    // the mapped file lives.
+    class mapped_file
+    {
+
+    public:
+
+        explicit mapped_file(const std::string& path)
+        {
+        #if defined(WHIRL_HAS_MMAP)
+            const auto fd = ::open(path.c_str(), O_RDONLY);
+
+            if (fd < 0)
+                throw std::system_error{ errno, std::generic_category(), path };
+
+            struct stat info;
+
+            if (::fstat(fd, &info) != 0)
+            {
+                const auto error = errno;
+                ::close(fd);
+                throw std::system_error{ error, std::generic_category(), path };
+            }
+
+            m_size = static_cast<std::size_t>(info.st_size);
+
+            // mapping zero bytes fails, an empty file is an empty view instead
+            if (m_size > 0)
+            {
+                const auto address = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+                if (address == MAP_FAILED)
+                {
+                    const auto error = errno;
+                    ::close(fd);
+                    throw std::system_error{ error, std::generic_category(), path };
+                }
+
+                m_data = static_cast<const char*>(address);
+
+                ::madvise(address, m_size, MADV_SEQUENTIAL);
+            }
+
+            ::close(fd);
+        #else
+            std::ifstream ifs(path, std::ios::binary);
+
+            if (!ifs.is_open())
+                throw std::system_error{
+                    std::make_error_code(std::errc::no_such_file_or_directory), path };
+
+            m_buffer.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+            m_data = m_buffer.data();
+            m_size = m_buffer.size();
+        #endif
+        }
+
+        mapped_file(const mapped_file&) = delete;
+        mapped_file& operator=(const mapped_file&) = delete;
+
+        ~mapped_file()
+        {
+        #if defined(WHIRL_HAS_MMAP)
+            if (m_data)
+                ::munmap(const_cast<char*>(m_data), m_size);
+        #endif
+        }
+
+        std::string_view view() const noexcept
+        {
+            return std::string_view{ m_data, m_size };
+        }
+
+        const char* data() const noexcept
+        {
+            return m_data;
+        }
+
+        std::size_t size() const noexcept
+        {
+            return m_size;
+        }
+
+    private:
+
+        const char* m_data = nullptr;
+        std::size_t m_size = 0;
+
+    #if !defined(WHIRL_HAS_MMAP)
+        std::string m_buffer;
+    #endif
+
+    };
+
+}
+
+
+#endif /*__MAPPED_FILE_HPP__*/
@@ -0,0 +1,183 @@
+#ifndef __PARALLEL_HPP__
+#define __PARALLEL_HPP__
+
+
+// Parallel parsing of separator delimited data. A contiguous buffer is split into chunks at
+// separator characters, the chunks are parsed on a thread pool and the results are concatenated in
+// the order of the chunks.
+//
+//   whirl::thread_pool pool;
+//   whirl::mapped_file file("data.txt");
+//   whirl::code_position pos{ 1, 1 };
+//
+//   const auto entries = whirl::parse_parallel(file.view(), pos, whirl::space,
+//       [](std::string_view& ins, whirl::code_position& pos) { return read_entries(ins, pos); },
+//       pool);
+
+
+#include <algorithm>
+#include <future>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "whirl.hpp"
+#include "scan.hpp"
+#include "thread_pool.hpp"
+
+
+namespace whirl
+{
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // parse errors
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // The offset and the position of the unexpected character relative to the whole buffer.
+    struct parallel_parse_error : unexpected_input
+    {
+        std::size_t offset;
+        code_position position;
+    };
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // chunking
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // Splits text into at most count chunks of about the same size. Every chunk but the first
+    // starts with a separator, hence tokens never straddle two chunks.
+    template <typename P, typename = requires_t<is_bound_predicate<P>>>
+    std::vector<std::string_view> split_at_separators(
+        std::string_view text, const P& separator, std::size_t count)
+    {
+        const code_unit_class separators{ separator };
+        const auto chunk_size = text.size() / std::max<std::size_t>(count, 1);
+
+        std::vector<std::string_view> chunks;
+        std::size_t first = 0;
+
+        for (std::size_t idx = 1; first < text.size(); ++idx)
+        {
+            auto last = idx >= count ? text.size() : std::max(first + 1, chunk_size * idx);
+
+            while (last < text.size() && !separators.contains(code_unit(text[last])))
+                ++last;
+
+            if (last > first)
+                chunks.push_back(text.substr(first, last - first));
+
+            first = last;
+        }
+
+        return chunks;
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // parallel parsing
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // Parses the chunks of text with parse_chunk(std::string_view& ins, code_position& pos), which
+    // has to return a sequence container like std::vector, and has to consume ins up to the
+    // unexpected character before throwing unexpected_input. The chunk parser has to accept leading
+    // separators and the end of the input after every entry. Returns the concatenated results.
+    //
+    // Throws parallel_parse_error for the first erroneous chunk. In that case pos is the position
+    // of the unexpected character, otherwise the position after the text.
+    //
+    // The pool is either a thread_pool or a work_stealing_pool. Only the latter may be used by a
+    // task running on the pool itself.
+    template <typename P, typename F, typename T, typename = requires_t<is_bound_predicate<P>>>
+    auto parse_parallel(
+        std::string_view text,
+        code_position& pos,
+        const P& separator,
+        F&& parse_chunk,
+        T& pool,
+        std::size_t chunk_count = 0)
+    {
+        using result_type = std::decay_t<
+            std::invoke_result_t<F&, std::string_view&, code_position&>>;
+
+        // more chunks than threads balance uneven parsing costs
+        if (chunk_count == 0)
+            chunk_count = 4 * pool.size();
+
+        const auto chunks = split_at_separators(text, separator, chunk_count);
+
+        std::vector<std::future<result_type>> parts;
+
+        parts.reserve(chunks.size());
+
+        for (const auto chunk : chunks)
+        {
+            parts.push_back(pool.submit([&parse_chunk, text, chunk]() {
+                std::string_view ins = chunk;
+                code_position chunk_pos{ 1, 1 };
+
+                try
+                {
+                    return parse_chunk(ins, chunk_pos);
+                }
+                catch (const unexpected_input&)
+                {
+                    parallel_parse_error error{ };
+
+                    error.offset = static_cast<std::size_t>(ins.data() - text.data());
+
+                    throw error;
+                }
+            }));
+        }
+
+        // the tasks refer to parse_chunk, hence all of them have to finish before unwinding
+        for (auto& part : parts)
+            pool.wait(part);
+
+        std::vector<result_type> results;
+
+        results.reserve(parts.size());
+
+        for (auto& part : parts)
+        {
+            try
+            {
+                results.push_back(part.get());
+            }
+            catch (parallel_parse_error& error)
+            {
+                pos.advance(text.substr(0, error.offset));
+                error.position = pos;
+
+                throw;
+            }
+        }
+
+        std::size_t total = 0;
+
+        for (const auto& part : results)
+            total += part.size();
+
+        result_type result;
+
+        result.reserve(total);
+
+        for (auto& part : results)
+        {
+            result.insert(
+                result.end(),
+                std::make_move_iterator(part.begin()),
+                std::make_move_iterator(part.end()));
+        }
+
+        pos.advance(text);
+
+        return result;
+    }
+
+}
+
+
+#endif /*__PARALLEL_HPP__*/
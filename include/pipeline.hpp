@@ -0,0 +1,358 @@
+#ifndef __PIPELINE_HPP__
+#define __PIPELINE_HPP__
+
+
+// Pipelined input sources overlap reading and parsing. A producer thread fills fixed-size chunks,
+// e.g. from a pipe, a decompressor or a socket, while the parsing thread consumes the chunks
+// filled before. Chunks are handed over through lock-free single-producer/single-consumer queues
+// and recycled afterwards, so the steady state allocates no memory.
+//
+//   std::ifstream ifs("data.txt");
+//   whirl::pipelined_source<char> ins(ifs);
+//
+//   whirl::next_while(ins, pos, whirl::space);
+
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "type_traits.hpp"
+
+
+namespace whirl
+{
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // single-producer/single-consumer queues
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // A bounded ring buffer, which is safe for exactly one pushing and one popping thread. The
+    // capacity is rounded up to a power of two.
+    template <typename T>
+    class spsc_queue
+    {
+
+    public:
+
+        explicit spsc_queue(std::size_t capacity)
+            : m_mask{ round_up(capacity) - 1 }
+            , m_slots{ new T[m_mask + 1] }
+        { }
+
+        std::size_t capacity() const noexcept
+        {
+            return m_mask + 1;
+        }
+
+        bool try_push(const T& value) noexcept(std::is_nothrow_copy_assignable_v<T>)
+        {
+            const auto tail = m_tail.load(std::memory_order_relaxed);
+
+            if (tail - m_head.load(std::memory_order_acquire) > m_mask)
+                return false;
+
+            m_slots[tail & m_mask] = value;
+            m_tail.store(tail + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        bool try_pop(T& value) noexcept(std::is_nothrow_move_assignable_v<T>)
+        {
+            const auto head = m_head.load(std::memory_order_relaxed);
+
+            if (head == m_tail.load(std::memory_order_acquire))
+                return false;
+
+            value = std::move(m_slots[head & m_mask]);
+            m_head.store(head + 1, std::memory_order_release);
+
+            return true;
+        }
+
+    private:
+
+        static std::size_t round_up(std::size_t capacity) noexcept
+        {
+            std::size_t result = 1;
+
+            while (result < capacity)
+                result *= 2;
+
+            return result;
+        }
+
+        // keeps the indices of producer and consumer on separate cache lines
+        static constexpr std::size_t cache_line_size = 64;
+
+        const std::size_t m_mask;
+        std::unique_ptr<T[]> m_slots;
+
+        alignas(cache_line_size) std::atomic<std::size_t> m_head{ 0 };
+        alignas(cache_line_size) std::atomic<std::size_t> m_tail{ 0 };
+
+    };
+
+    namespace detail
+    {
+        // Spins briefly, then yields and finally sleeps, so a slow counterpart doesn't cost a
+        // whole core.
+        class backoff
+        {
+
+        public:
+
+            void wait() noexcept
+            {
+                if (m_rounds < 64)
+                    std::this_thread::yield();
+                else
+                    std::this_thread::sleep_for(std::chrono::microseconds{ 50 });
+
+                ++m_rounds;
+            }
+
+        private:
+
+            unsigned m_rounds = 0;
+
+        };
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // pipelined input sources
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // The producer function copies up to capacity characters to the buffer and returns their
+    // count. Returning zero ends the input. Exceptions thrown by the producer are rethrown when the
+    // consumer skips the last character produced before, or by the constructor.
+    //
+    // Chunk boundaries are invisible to consumers, hence tokens may straddle them. The source is
+    // neither copyable nor movable, as the producer thread refers to it.
+    template <typename C = char>
+    class pipelined_source
+    {
+
+        static_assert(is_character_type_v<C>);
+
+    public:
+
+        using char_type = C;
+        using producer_type = std::function<std::size_t(C* buffer, std::size_t capacity)>;
+
+        static constexpr std::size_t default_chunk_size = 64 * 1024;
+        static constexpr std::size_t default_chunk_count = 8;
+
+
+        explicit pipelined_source(
+            producer_type produce,
+            std::size_t chunk_size = default_chunk_size,
+            std::size_t chunk_count = default_chunk_count)
+            : m_chunk_size{ std::max<std::size_t>(chunk_size, 1) }
+            , m_buffers(std::max<std::size_t>(chunk_count, 2) * m_chunk_size)
+            , m_full{ std::max<std::size_t>(chunk_count, 2) }
+            , m_free{ std::max<std::size_t>(chunk_count, 2) }
+        {
+            for (std::size_t idx = 0; idx < this->chunk_count(); ++idx)
+                m_free.try_push(idx);
+
+            m_producer = std::thread{ [this, produce = std::move(produce)]() {
+                this->produce(produce);
+            } };
+
+            // the destructor doesn't run, if the first chunk already fails
+            try
+            {
+                this->fetch();
+            }
+            catch (...)
+            {
+                m_producer.join();
+                throw;
+            }
+        }
+
+        // reads the stream in the producer thread
+        explicit pipelined_source(
+            std::basic_istream<C>& ins,
+            std::size_t chunk_size = default_chunk_size,
+            std::size_t chunk_count = default_chunk_count)
+            : pipelined_source{
+                [&ins](C* buffer, std::size_t capacity) {
+                    ins.read(buffer, static_cast<std::streamsize>(capacity));
+                    return static_cast<std::size_t>(ins.gcount());
+                },
+                chunk_size,
+                chunk_count
+            }
+        { }
+
+        pipelined_source(const pipelined_source&) = delete;
+        pipelined_source& operator=(const pipelined_source&) = delete;
+
+        // A producer call in progress is awaited, the remaining input is discarded.
+        ~pipelined_source()
+        {
+            m_stopping.store(true, std::memory_order_relaxed);
+            m_producer.join();
+        }
+
+        // The next chunk is fetched as soon as the current one is consumed, hence looking ahead
+        // needs no checks.
+        C look_ahead() const noexcept
+        {
+            return m_chunk[m_pos];
+        }
+
+        void ignore()
+        {
+            if (!m_done && ++m_pos == m_size)
+                this->fetch();
+        }
+
+        bool at_end() const noexcept
+        {
+            return m_done;
+        }
+
+    private:
+
+        struct filled_chunk
+        {
+            std::size_t index;
+            std::size_t size;
+        };
+
+        std::size_t chunk_count() const noexcept
+        {
+            return m_buffers.size() / m_chunk_size;
+        }
+
+        C* buffer(std::size_t index) noexcept
+        {
+            return m_buffers.data() + index * m_chunk_size;
+        }
+
+        // runs in the producer thread
+        void produce(const producer_type& produce)
+        {
+            for (;;)
+            {
+                std::size_t index;
+
+                for (detail::backoff waiting; !m_free.try_pop(index); waiting.wait())
+                {
+                    if (m_stopping.load(std::memory_order_relaxed))
+                        return;
+                }
+
+                std::size_t size = 0;
+
+                try
+                {
+                    size = produce(this->buffer(index), m_chunk_size);
+                }
+                catch (...)
+                {
+                    m_error = std::current_exception();
+                }
+
+                // an empty chunk marks the end of the input
+                m_full.try_push(filled_chunk{ index, size });
+
+                if (size == 0)
+                    return;
+            }
+        }
+
+        // Returns the used chunk to the producer and waits for the next one. At the end of the
+        // input the look ahead becomes eof.
+        void fetch()
+        {
+            if (m_chunk != &m_end)
+                m_free.try_push(m_index);
+
+            filled_chunk chunk;
+
+            for (detail::backoff waiting; !m_full.try_pop(chunk); waiting.wait())
+            { }
+
+            m_index = chunk.index;
+            m_chunk = this->buffer(chunk.index);
+            m_size = chunk.size;
+            m_pos = 0;
+
+            if (chunk.size > 0)
+                return;
+
+            m_chunk = &m_end;
+            m_pos = 0;
+            m_done = true;
+
+            // the error is published by the release store of the end chunk
+            if (m_error)
+                std::rethrow_exception(m_error);
+        }
+
+        const std::size_t m_chunk_size;
+        std::vector<C> m_buffers;
+        spsc_queue<filled_chunk> m_full;
+        spsc_queue<std::size_t> m_free;
+        std::exception_ptr m_error;
+        std::atomic<bool> m_stopping{ false };
+        std::thread m_producer;
+
+        // consumer state
+        const C m_end = static_cast<C>(std::char_traits<C>::eof());
+        const C* m_chunk = &m_end;
+        std::size_t m_index = 0;
+        std::size_t m_size = 0;
+        std::size_t m_pos = 0;
+        bool m_done = false;
+
+    };
+
+    template <typename C>
+    struct input_source_traits<pipelined_source<C>>
+    {
+        using char_type = C;
+
+        static char_type look_ahead(pipelined_source<C>& ins) noexcept
+        {
+            return ins.look_ahead();
+        }
+
+        static char_type read(pipelined_source<C>& ins)
+        {
+            const auto chr = ins.look_ahead();
+
+            ins.ignore();
+
+            return chr;
+        }
+
+        static void ignore(pipelined_source<C>& ins)
+        {
+            ins.ignore();
+        }
+
+        static bool is_end(pipelined_source<C>& ins) noexcept
+        {
+            return ins.at_end();
+        }
+    };
+
+}
+
+
+#endif /*__PIPELINE_HPP__*/
@@ -0,0 +1,249 @@
+#ifndef __QUOTED_HPP__
+#define __QUOTED_HPP__
+
+
+// Quoted strings with escape sequences. On contiguous sources the quote and escape characters are
+// searched 16 at a time with SSE2, and a string without escape sequences is returned as a view
+// into the source. Otherwise it's decoded into a buffer supplied by the caller, e.g. a string
+// reused for every string read or an arena string, and returned as a view into the buffer.
+//
+//   std::string buffer;
+//
+//   const auto name = whirl::read_quoted(ins, buffer);
+//   const auto field = whirl::read_quoted(ins, buffer, '\'', '\'');
+//
+// An escape character followed by n, t, r or 0 yields the respective control character, followed
+// by any other character it yields that character. If the quote is its own escape character, as
+// in CSV, only doubled quotes are escape sequences.
+
+
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+
+#include "whirl.hpp"
+#include "delimiter.hpp"
+
+
+namespace whirl
+{
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // quoted string reading
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    namespace detail
+    {
+        template <typename C>
+        constexpr C unescape(C chr) noexcept
+        {
+            switch (chr)
+            {
+                case C('n'): return C('\n');
+                case C('t'): return C('\t');
+                case C('r'): return C('\r');
+                case C('0'): return C('\0');
+                default:     return chr;
+            }
+        }
+
+        template <typename I, typename B, typename C>
+        std::basic_string_view<C> read_contiguous_quoted(
+            I& ins, code_position* pos, B& buffer, C quote, C escape)
+        {
+            using traits = input_source_traits<I>;
+
+            const auto first = traits::data(ins);
+            const auto size = traits::size(ins);
+
+            if (size == 0 || first[0] != quote)
+                throw unexpected_input{ };
+
+            // the content of the string starts after the opening quote
+            const auto body = first + 1;
+            const auto body_size = size - 1;
+
+            auto idx = find_one_of(body, body_size, quote, escape);
+            auto decoded = false;
+
+            for (std::size_t start = 0;; idx = start + find_one_of(
+                body + start, body_size - start, quote, escape))
+            {
+                if (idx == body_size)
+                {
+                    traits::advance(ins, size);
+                    throw unexpected_input{ };
+                }
+
+                const auto escaped = body[idx] == escape
+                    && (escape != quote || (idx + 1 < body_size && body[idx + 1] == quote));
+
+                if (!escaped && !decoded)
+                    break;
+
+                if (!decoded)
+                {
+                    buffer.clear();
+                    decoded = true;
+                }
+
+                buffer.append(body + start, idx - start);
+
+                if (!escaped)
+                    break;
+
+                if (idx + 1 == body_size)
+                {
+                    traits::advance(ins, size);
+                    throw unexpected_input{ };
+                }
+
+                buffer.push_back(unescape(body[idx + 1]));
+                start = idx + 2;
+            }
+
+            const auto consumed = idx + 2;
+
+            if (pos)
+                pos->advance(std::basic_string_view<C>{ first, consumed });
+
+            traits::advance(ins, consumed);
+
+            if (decoded)
+                return std::basic_string_view<C>{ buffer.data(), buffer.size() };
+
+            return std::basic_string_view<C>{ body, idx };
+        }
+
+        template <typename I, typename B, typename C>
+        std::basic_string_view<C> read_streamed_quoted(
+            I& ins, code_position* pos, B& buffer, C quote, C escape)
+        {
+            using traits = input_source_traits<I>;
+
+            const auto read = [&ins, pos]() {
+                if (traits::is_end(ins))
+                    throw unexpected_input{ };
+
+                return pos ? next(ins, *pos, as_is) : next(ins, as_is);
+            };
+
+            if (traits::is_end(ins) || traits::look_ahead(ins) != quote)
+                throw unexpected_input{ };
+
+            read();
+            buffer.clear();
+
+            for (;;)
+            {
+                const auto chr = read();
+
+                if (chr == escape && escape == quote)
+                {
+                    if (traits::is_end(ins) || traits::look_ahead(ins) != quote)
+                        break;
+
+                    buffer.push_back(read());
+                }
+                else if (chr == escape)
+                {
+                    buffer.push_back(unescape(read()));
+                }
+                else if (chr == quote)
+                {
+                    break;
+                }
+                else
+                {
+                    buffer.push_back(chr);
+                }
+            }
+
+            return std::basic_string_view<C>{ buffer.data(), buffer.size() };
+        }
+
+        template <typename I, typename B, typename C>
+        std::basic_string_view<C> read_quoted(
+            I& ins, code_position* pos, B& buffer, C quote, C escape)
+        {
+            static_assert(std::is_same_v<typename B::value_type, C>);
+
+            if constexpr (is_contiguous_input_source_type_v<I>)
+                return read_contiguous_quoted(ins, pos, buffer, quote, escape);
+            else
+                return read_streamed_quoted(ins, pos, buffer, quote, escape);
+        }
+    }
+
+    // Reads a quoted string and returns its content, as a view into the source or the buffer. The
+    // buffer is cleared before decoding. Throws unexpected_input if the look ahead isn't a quote,
+    // or the input ends before the closing quote.
+    template <typename I, typename B, typename = requires_t<is_input_source_type<I>>>
+    auto read_quoted(
+        I& ins,
+        B& buffer,
+        typename input_source_traits<I>::char_type quote = '"',
+        typename input_source_traits<I>::char_type escape = '\\')
+    {
+        return detail::read_quoted(ins, nullptr, buffer, quote, escape);
+    }
+
+    template <typename I, typename B, typename = requires_t<is_input_source_type<I>>>
+    auto read_quoted(
+        I& ins,
+        code_position& pos,
+        B& buffer,
+        typename input_source_traits<I>::char_type quote = '"',
+        typename input_source_traits<I>::char_type escape = '\\')
+    {
+        return detail::read_quoted(ins, &pos, buffer, quote, escape);
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // bound quoted string consumers
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // The buffer has to outlive the consumer.
+    template <typename B>
+    struct bound_quoted_read
+    {
+
+        using char_type = typename B::value_type;
+
+
+        constexpr bound_quoted_read(B& buffer, char_type quote, char_type escape)
+            : buffer{ &buffer }
+            , quote{ quote }
+            , escape{ escape }
+        { }
+
+        template <typename I>
+        auto operator()(I& ins) const
+        {
+            return read_quoted(ins, *this->buffer, this->quote, this->escape);
+        }
+
+        template <typename I>
+        auto operator()(I& ins, code_position& pos) const
+        {
+            return read_quoted(ins, pos, *this->buffer, this->quote, this->escape);
+        }
+
+        B* buffer;
+        char_type quote;
+        char_type escape;
+
+    };
+
+    template <typename B>
+    constexpr auto read_quoted(
+        B& buffer, typename B::value_type quote = '"', typename B::value_type escape = '\\')
+    {
+        return bound_quoted_read<B>{ buffer, quote, escape };
+    }
+
+}
+
+
+#endif /*__QUOTED_HPP__*/
@@ -0,0 +1,1069 @@
+#ifndef __REGEX_HPP__
+#define __REGEX_HPP__
+
+
+// Regular expressions compiled to a minimized DFA at compile time.
+//
+//   constexpr auto number = whirl::regex("-?(0|[1-9][0-9]*)");
+//
+//   number(ins, pos);
+//
+// Supported syntax: literals, '.', character classes like [a-z_] or [^,], the class escapes \d, \s,
+// \w and their negations, alternation, grouping and the quantifiers *, +, ? and {n}, {n,}, {n,m}.
+// Patterns match code units in the range of 0 to 255. Matching consumes the longest prefix, which
+// matches the pattern, e.g. "ab|abcd" consumes "ab" of "abce".
+//
+// Limitation: sources, which are neither contiguous nor rewindable, e.g. plain streams, can't put
+// back characters read past the longest match. Such a match fails with unexpected_input instead,
+// unless the source is wrapped in a replay_source.
+
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#include "whirl.hpp"
+#include "character_set.hpp"
+
+
+namespace whirl
+{
+
+    struct invalid_regex { };
+    struct regex_too_complex { };
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // compiled regular expressions
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // A DFA over byte classes: code units with the same behaviour in every state share a class and
+    // thus a column of the dense transition table. State 0 is the dead state.
+    template <std::size_t S, std::size_t K>
+    struct regex_dfa
+    {
+
+        static_assert(S > 0 && S <= 256);
+        static_assert(K > 0 && K <= 256);
+
+
+        using state_type = unsigned char;
+
+        static constexpr state_type dead_state = 0;
+
+
+        constexpr state_type transition(state_type state, std::size_t unit) const noexcept
+        {
+            if (unit >= character_set::domain_size)
+                return dead_state;
+
+            return this->transitions[state * K + this->classes[unit]];
+        }
+
+        constexpr bool is_accepting(state_type state) const noexcept
+        {
+            return this->accepting[state];
+        }
+
+        constexpr bool matches(std::string_view text) const noexcept
+        {
+            auto state = this->start;
+
+            for (auto chr : text)
+                state = this->transition(state, code_unit(chr));
+
+            return this->is_accepting(state);
+        }
+
+        template <typename I>
+        constexpr bool starts(I& ins) const
+        {
+            return !input_source_traits<I>::is_end(ins) &&
+                this->transition(
+                    this->start, code_unit(input_source_traits<I>::look_ahead(ins))
+                ) != dead_state;
+        }
+
+        // Returns the number of consumed characters and throws unexpected_input if no prefix of the
+        // input matches.
+        template <typename I, typename = requires_t<is_input_source_type<I>>>
+        constexpr std::size_t operator()(I& ins) const
+        {
+            if constexpr (is_contiguous_input_source_type_v<I>)
+            {
+                const auto count = this->scan(
+                    input_source_traits<I>::data(ins), input_source_traits<I>::size(ins));
+
+                input_source_traits<I>::advance(ins, count);
+
+                return count;
+            }
+            else
+            {
+                return this->consume(ins, nullptr);
+            }
+        }
+
+        template <typename I, typename = requires_t<is_input_source_type<I>>>
+        constexpr std::size_t operator()(I& ins, code_position& pos) const
+        {
+            if constexpr (is_contiguous_input_source_type_v<I>)
+            {
+                const auto first = input_source_traits<I>::data(ins);
+                const auto count = this->scan(first, input_source_traits<I>::size(ins));
+
+                pos.advance(std::basic_string_view<typename input_source_traits<I>::char_type>{
+                    first, count });
+
+                input_source_traits<I>::advance(ins, count);
+
+                return count;
+            }
+            else
+            {
+                return this->consume(ins, &pos);
+            }
+        }
+
+        std::array<unsigned char, character_set::domain_size> classes;
+        std::array<state_type, S * K> transitions;
+        std::array<bool, S> accepting;
+        std::size_t state_count;
+        std::size_t class_count;
+        state_type start;
+
+    private:
+
+        static constexpr auto no_match = static_cast<std::size_t>(-1);
+
+        // Returns the length of the longest matching prefix.
+        template <typename C>
+        constexpr std::size_t scan(const C* first, std::size_t size) const
+        {
+            auto state = this->start;
+            auto accepted = this->is_accepting(state) ? 0 : no_match;
+
+            for (std::size_t count = 0; count < size; ++count)
+            {
+                state = this->transition(state, code_unit(first[count]));
+
+                if (state == dead_state)
+                    break;
+
+                if (this->is_accepting(state))
+                    accepted = count + 1;
+            }
+
+            if (accepted == no_match)
+                throw unexpected_input{};
+
+            return accepted;
+        }
+
+        // Consumes characters as long as the match can be extended. Rewindable sources are rewound
+        // to the end of the longest match afterwards, other sources have to end in a match.
+        template <typename I>
+        constexpr std::size_t consume(I& ins, code_position* pos) const
+        {
+            using traits = input_source_traits<I>;
+
+            auto state = this->start;
+            std::size_t count = 0;
+
+            if constexpr (is_rewindable_input_source_type_v<I>)
+            {
+                auto accepted = this->is_accepting(state) ? 0 : no_match;
+                auto accepted_mark = traits::mark(ins);
+                auto accepted_pos = pos ? *pos : code_position{ };
+
+                while (!traits::is_end(ins))
+                {
+                    state = this->transition(state, code_unit(traits::look_ahead(ins)));
+
+                    if (state == dead_state)
+                        break;
+
+                    pos ? pos->update(traits::read(ins)) : traits::ignore(ins);
+                    ++count;
+
+                    if (this->is_accepting(state))
+                    {
+                        accepted = count;
+                        accepted_mark = traits::mark(ins);
+
+                        if (pos)
+                            accepted_pos = *pos;
+                    }
+                }
+
+                if (accepted == no_match)
+                    throw unexpected_input{};
+
+                if (accepted != count)
+                {
+                    traits::rewind(ins, accepted_mark);
+
+                    if (pos)
+                        *pos = accepted_pos;
+                }
+
+                return accepted;
+            }
+            else
+            {
+                while (!traits::is_end(ins))
+                {
+                    const auto next_state = this->transition(
+                        state, code_unit(traits::look_ahead(ins)));
+
+                    if (next_state == dead_state)
+                        break;
+
+                    pos ? pos->update(traits::read(ins)) : traits::ignore(ins);
+                    state = next_state;
+                    ++count;
+                }
+
+                if (!this->is_accepting(state))
+                    throw unexpected_input{};
+
+                return count;
+            }
+        }
+
+    };
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // regular expression compiler
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    namespace detail
+    {
+        template <std::size_t N>
+        struct regex_position_set
+        {
+            constexpr bool contains(std::size_t idx) const noexcept
+            {
+                return (words[idx / 64] >> (idx % 64)) & 1u;
+            }
+
+            constexpr void insert(std::size_t idx) noexcept
+            {
+                words[idx / 64] |= std::uint64_t{ 1 } << (idx % 64);
+            }
+
+            constexpr regex_position_set& operator|=(const regex_position_set& other) noexcept
+            {
+                for (std::size_t idx = 0; idx < words.size(); ++idx)
+                    words[idx] |= other.words[idx];
+
+                return *this;
+            }
+
+            constexpr bool intersects(const regex_position_set& other) const noexcept
+            {
+                for (std::size_t idx = 0; idx < words.size(); ++idx)
+                {
+                    if (words[idx] & other.words[idx])
+                        return true;
+                }
+
+                return false;
+            }
+
+            friend constexpr bool operator==(
+                const regex_position_set& lhs, const regex_position_set& rhs) noexcept
+            {
+                for (std::size_t idx = 0; idx < lhs.words.size(); ++idx)
+                {
+                    if (lhs.words[idx] != rhs.words[idx])
+                        return false;
+                }
+
+                return true;
+            }
+
+            std::array<std::uint64_t, (N + 63) / 64> words{ };
+        };
+
+        // Summary of a parsed subexpression as needed by the Glushkov construction.
+        template <std::size_t N>
+        struct regex_fragment
+        {
+            bool nullable;
+            regex_position_set<N> first;
+            regex_position_set<N> last;
+        };
+
+        // Recursive descent parser, which builds the position automaton while parsing. Every
+        // occurrence of a character class is a position, quantified subexpressions are parsed
+        // once per copy.
+        template <std::size_t P>
+        class regex_parser
+        {
+
+        public:
+
+            using fragment = regex_fragment<P + 1>;
+
+
+            constexpr regex_parser()
+                : m_pattern{ nullptr }
+                , m_size{ 0 }
+                , m_cursor{ 0 }
+                , m_sets{ }
+                , m_follow{ }
+                , m_position_count{ 0 }
+            { }
+
+            // Patterns parsed by the same parser share one position automaton.
+            constexpr fragment parse(const char* pattern, std::size_t size)
+            {
+                m_pattern = pattern;
+                m_size = size;
+                m_cursor = 0;
+
+                const auto frag = this->parse_alternation();
+
+                if (m_cursor != m_size)
+                    throw invalid_regex{};
+
+                return frag;
+            }
+
+            constexpr fragment add(const character_set& set)
+            {
+                return this->position(set);
+            }
+
+            constexpr std::size_t position_count() const noexcept
+            {
+                return m_position_count;
+            }
+
+            constexpr const character_set& set(std::size_t pos) const noexcept
+            {
+                return m_sets[pos];
+            }
+
+            constexpr regex_position_set<P + 1>& follow(std::size_t pos) noexcept
+            {
+                return m_follow[pos];
+            }
+
+        private:
+
+            constexpr bool at_end() const noexcept
+            {
+                return m_cursor == m_size;
+            }
+
+            constexpr char peek() const noexcept
+            {
+                return m_pattern[m_cursor];
+            }
+
+            constexpr char get()
+            {
+                if (this->at_end())
+                    throw invalid_regex{};
+
+                return m_pattern[m_cursor++];
+            }
+
+            constexpr fragment parse_alternation()
+            {
+                auto frag = this->parse_concatenation();
+
+                while (!this->at_end() && this->peek() == '|')
+                {
+                    ++m_cursor;
+
+                    const auto alt = this->parse_concatenation();
+
+                    frag.nullable = frag.nullable || alt.nullable;
+                    frag.first |= alt.first;
+                    frag.last |= alt.last;
+                }
+
+                return frag;
+            }
+
+            constexpr fragment parse_concatenation()
+            {
+                fragment frag{ true, { }, { } };
+
+                while (!this->at_end() && this->peek() != '|' && this->peek() != ')')
+                    frag = this->concat(frag, this->parse_quantified());
+
+                return frag;
+            }
+
+            constexpr fragment parse_quantified()
+            {
+                const auto begin = m_cursor;
+                auto frag = this->parse_atom();
+
+                while (!this->at_end())
+                {
+                    const auto chr = this->peek();
+
+                    if (chr == '*' || chr == '+' || chr == '?')
+                    {
+                        ++m_cursor;
+
+                        if (chr != '?')
+                            this->loop(frag);
+
+                        if (chr != '+')
+                            frag.nullable = true;
+                    }
+                    else if (chr == '{')
+                    {
+                        const auto end = m_cursor;
+
+                        ++m_cursor;
+
+                        const auto min = this->parse_count();
+                        auto max = min;
+                        auto unbounded = false;
+
+                        if (this->get() == ',')
+                        {
+                            unbounded = this->peek() == '}';
+                            max = unbounded ? min : this->parse_count();
+
+                            if (this->get() != '}')
+                                throw invalid_regex{};
+                        }
+                        else if (m_pattern[m_cursor - 1] != '}')
+                        {
+                            throw invalid_regex{};
+                        }
+
+                        if (max < min)
+                            throw invalid_regex{};
+
+                        const auto resume = m_cursor;
+
+                        frag = this->repeat(frag, begin, end, min, max, unbounded);
+                        m_cursor = resume;
+                    }
+                    else
+                    {
+                        break;
+                    }
+                }
+
+                return frag;
+            }
+
+            // The first copy is the already parsed fragment, all further copies are parsed again
+            // from the pattern to get distinct positions.
+            constexpr fragment repeat(
+                const fragment& once,
+                std::size_t begin,
+                std::size_t end,
+                std::size_t min,
+                std::size_t max,
+                bool unbounded)
+            {
+                auto first_copy = true;
+
+                const auto next_copy = [&]() {
+                    if (first_copy)
+                    {
+                        first_copy = false;
+                        return once;
+                    }
+
+                    m_cursor = begin;
+
+                    return this->parse_quantified_until(end);
+                };
+
+                fragment frag{ true, { }, { } };
+
+                for (std::size_t idx = 0; idx < min; ++idx)
+                    frag = this->concat(frag, next_copy());
+
+                if (unbounded)
+                {
+                    auto tail = next_copy();
+
+                    this->loop(tail);
+                    tail.nullable = true;
+
+                    return this->concat(frag, tail);
+                }
+
+                // a{2,4} is built as a a (a (a)?)?, hence the optional copies are parsed first and
+                // nested from the inside out afterwards.
+                const auto optional_count = max - min;
+                std::array<fragment, P> optionals{ };
+
+                if (optional_count > P)
+                    throw regex_too_complex{};
+
+                for (std::size_t idx = 0; idx < optional_count; ++idx)
+                    optionals[idx] = next_copy();
+
+                fragment optional_tail{ true, { }, { } };
+
+                for (std::size_t idx = optional_count; idx-- > 0;)
+                {
+                    optional_tail = this->concat(optionals[idx], optional_tail);
+                    optional_tail.nullable = true;
+                }
+
+                return this->concat(frag, optional_tail);
+            }
+
+            constexpr fragment parse_quantified_until(std::size_t end)
+            {
+                auto frag = this->parse_atom();
+
+                while (m_cursor < end)
+                {
+                    const auto chr = this->get();
+
+                    if (chr == '*' || chr == '+')
+                        this->loop(frag);
+
+                    if (chr == '*' || chr == '?')
+                        frag.nullable = true;
+
+                    if (chr == '{')
+                        throw regex_too_complex{};
+                }
+
+                return frag;
+            }
+
+            constexpr std::size_t parse_count()
+            {
+                std::size_t count = 0;
+                std::size_t digits = 0;
+
+                while (!this->at_end() && this->peek() >= '0' && this->peek() <= '9')
+                {
+                    count = count * 10 + static_cast<std::size_t>(this->get() - '0');
+
+                    if (++digits > 3)
+                        throw regex_too_complex{};
+                }
+
+                if (digits == 0)
+                    throw invalid_regex{};
+
+                return count;
+            }
+
+            constexpr fragment parse_atom()
+            {
+                const auto chr = this->get();
+
+                switch (chr)
+                {
+                    case '(':
+                    {
+                        const auto frag = this->parse_alternation();
+
+                        if (this->get() != ')')
+                            throw invalid_regex{};
+
+                        return frag;
+                    }
+
+                    case '[':
+                        return this->position(this->parse_class());
+
+                    case '.':
+                    {
+                        auto set = complement(single('\n'));
+
+                        return this->position(set);
+                    }
+
+                    case '\\':
+                        return this->position(this->parse_escape());
+
+                    case ')': case '|': case '*': case '+': case '?': case '{': case '}': case ']':
+                        throw invalid_regex{};
+
+                    default:
+                        return this->position(single(chr));
+                }
+            }
+
+            constexpr character_set parse_escape()
+            {
+                const auto chr = this->get();
+
+                switch (chr)
+                {
+                    case 'd': return digits();
+                    case 'D': return complement(digits());
+                    case 's': return spaces();
+                    case 'S': return complement(spaces());
+                    case 'w': return word_characters();
+                    case 'W': return complement(word_characters());
+                    case 'n': return single('\n');
+                    case 'r': return single('\r');
+                    case 't': return single('\t');
+                    case 'f': return single('\f');
+                    case 'v': return single('\v');
+                    case '0': return single('\0');
+                    default:  return single(chr);
+                }
+            }
+
+            constexpr character_set parse_class()
+            {
+                auto negated = false;
+
+                if (!this->at_end() && this->peek() == '^')
+                {
+                    negated = true;
+                    ++m_cursor;
+                }
+
+                character_set set;
+                auto leading = true;
+
+                while (leading || this->peek() != ']')
+                {
+                    if (this->at_end())
+                        throw invalid_regex{};
+
+                    leading = false;
+
+                    auto chr = this->get();
+
+                    if (chr == '\\')
+                    {
+                        const auto escaped = this->parse_escape();
+
+                        if (!is_single(escaped))
+                        {
+                            set |= escaped;
+                            continue;
+                        }
+
+                        chr = static_cast<char>(lowest(escaped));
+                    }
+
+                    if (m_cursor + 1 < m_size && this->peek() == '-' &&
+                        m_pattern[m_cursor + 1] != ']')
+                    {
+                        ++m_cursor;
+
+                        auto upper = this->get();
+
+                        if (upper == '\\')
+                        {
+                            const auto escaped = this->parse_escape();
+
+                            if (!is_single(escaped))
+                                throw invalid_regex{};
+
+                            upper = static_cast<char>(lowest(escaped));
+                        }
+
+                        if (code_unit(upper) < code_unit(chr))
+                            throw invalid_regex{};
+
+                        for (std::size_t unit = code_unit(chr); unit <= code_unit(upper); ++unit)
+                            set.insert(unit);
+                    }
+                    else
+                    {
+                        set.insert(code_unit(chr));
+                    }
+                }
+
+                ++m_cursor;
+
+                return negated ? complement(set) : set;
+            }
+
+            constexpr fragment position(const character_set& set)
+            {
+                if (m_position_count == P)
+                    throw regex_too_complex{};
+
+                const auto pos = m_position_count++;
+
+                m_sets[pos] = set;
+
+                fragment frag{ false, { }, { } };
+
+                frag.first.insert(pos);
+                frag.last.insert(pos);
+
+                return frag;
+            }
+
+            constexpr fragment concat(const fragment& lhs, const fragment& rhs)
+            {
+                for (std::size_t pos = 0; pos < m_position_count; ++pos)
+                {
+                    if (lhs.last.contains(pos))
+                        m_follow[pos] |= rhs.first;
+                }
+
+                fragment frag{ lhs.nullable && rhs.nullable, lhs.first, rhs.last };
+
+                if (lhs.nullable)
+                    frag.first |= rhs.first;
+
+                if (rhs.nullable)
+                    frag.last |= lhs.last;
+
+                return frag;
+            }
+
+            constexpr void loop(const fragment& frag)
+            {
+                for (std::size_t pos = 0; pos < m_position_count; ++pos)
+                {
+                    if (frag.last.contains(pos))
+                        m_follow[pos] |= frag.first;
+                }
+            }
+
+            static constexpr character_set single(char chr)
+            {
+                character_set set;
+
+                set.insert(code_unit(chr));
+
+                return set;
+            }
+
+            static constexpr character_set range(char lower, char upper)
+            {
+                character_set set;
+
+                for (std::size_t unit = code_unit(lower); unit <= code_unit(upper); ++unit)
+                    set.insert(unit);
+
+                return set;
+            }
+
+            static constexpr character_set digits()
+            {
+                return range('0', '9');
+            }
+
+            static constexpr character_set spaces()
+            {
+                return single(' ') | single('\t') | single('\n') | single('\r') | single('\f') |
+                    single('\v');
+            }
+
+            static constexpr character_set word_characters()
+            {
+                return range('a', 'z') | range('A', 'Z') | range('0', '9') | single('_');
+            }
+
+            static constexpr character_set complement(const character_set& set)
+            {
+                character_set result;
+
+                for (std::size_t unit = 0; unit < character_set::domain_size; ++unit)
+                {
+                    if (!set.contains(unit))
+                        result.insert(unit);
+                }
+
+                return result;
+            }
+
+            static constexpr bool is_single(const character_set& set)
+            {
+                std::size_t count = 0;
+
+                for (std::size_t unit = 0; unit < character_set::domain_size; ++unit)
+                    count += set.contains(unit);
+
+                return count == 1;
+            }
+
+            static constexpr std::size_t lowest(const character_set& set)
+            {
+                std::size_t unit = 0;
+
+                while (!set.contains(unit))
+                    ++unit;
+
+                return unit;
+            }
+
+            const char* m_pattern;
+            std::size_t m_size;
+            std::size_t m_cursor;
+            std::array<character_set, P> m_sets;
+            std::array<regex_position_set<P + 1>, P + 1> m_follow;
+            std::size_t m_position_count;
+
+        };
+
+        // Tables of a minimized DFA, whose accepting states are tagged with the index of the
+        // pattern they accept. Lower indices take precedence.
+        template <std::size_t S, std::size_t K>
+        struct dfa_tables
+        {
+            static constexpr unsigned char no_tag = 255;
+
+            std::array<unsigned char, character_set::domain_size> classes;
+            std::array<unsigned char, S * K> transitions;
+            std::array<unsigned char, S> tags;
+            std::size_t state_count;
+            std::size_t class_count;
+            unsigned char start;
+        };
+
+        template <std::size_t S, std::size_t K, std::size_t P, std::size_t T>
+        constexpr auto build_dfa(
+            regex_parser<P>& parser,
+            const std::array<regex_position_set<P + 1>, T>& lasts,
+            const regex_position_set<P + 1>& first)
+        {
+            using position_set = regex_position_set<P + 1>;
+            using tables_type = dfa_tables<S, K>;
+
+            const auto positions = parser.position_count();
+
+            // The start state is a virtual position in front of the first position.
+            const auto start = positions;
+
+            parser.follow(start) = first;
+
+            // byte classes by successive refinement with every position's set
+            std::array<unsigned char, character_set::domain_size> classes{ };
+            std::size_t class_count = 1;
+
+            for (std::size_t pos = 0; pos < positions; ++pos)
+            {
+                std::array<std::size_t, 2 * K> refined{ };
+                std::size_t refined_count = 0;
+
+                for (auto& id : refined)
+                    id = K;
+
+                for (std::size_t unit = 0; unit < character_set::domain_size; ++unit)
+                {
+                    auto& id = refined[classes[unit] * 2 + parser.set(pos).contains(unit)];
+
+                    if (id == K)
+                    {
+                        if (refined_count == K)
+                            throw regex_too_complex{};
+
+                        id = refined_count++;
+                    }
+
+                    classes[unit] = static_cast<unsigned char>(id);
+                }
+
+                class_count = refined_count;
+            }
+
+            std::array<std::size_t, K> representatives{ };
+
+            for (std::size_t unit = character_set::domain_size; unit-- > 0;)
+                representatives[classes[unit]] = unit;
+
+            // subset construction, state 0 is the dead state
+            constexpr std::size_t max_subsets = 255;
+
+            std::array<position_set, max_subsets> subsets{ };
+            std::array<unsigned char, max_subsets * K> subset_transitions{ };
+            std::size_t subset_count = 2;
+
+            subsets[1].insert(start);
+
+            for (std::size_t state = 1; state < subset_count; ++state)
+            {
+                position_set reachable;
+
+                for (std::size_t pos = 0; pos <= positions; ++pos)
+                {
+                    if (subsets[state].contains(pos))
+                        reachable |= parser.follow(pos);
+                }
+
+                for (std::size_t cls = 0; cls < class_count; ++cls)
+                {
+                    position_set next;
+
+                    for (std::size_t pos = 0; pos < positions; ++pos)
+                    {
+                        if (reachable.contains(pos) &&
+                            parser.set(pos).contains(representatives[cls]))
+                        {
+                            next.insert(pos);
+                        }
+                    }
+
+                    std::size_t target = 0;
+
+                    while (target < subset_count && !(subsets[target] == next))
+                        ++target;
+
+                    if (target == subset_count)
+                    {
+                        if (subset_count == max_subsets)
+                            throw regex_too_complex{};
+
+                        subsets[subset_count++] = next;
+                    }
+
+                    subset_transitions[state * K + cls] = static_cast<unsigned char>(target);
+                }
+            }
+
+            std::array<unsigned char, max_subsets> subset_tags{ };
+
+            for (std::size_t state = 0; state < subset_count; ++state)
+            {
+                std::size_t tag = 0;
+
+                while (tag < T && !subsets[state].intersects(lasts[tag]))
+                    ++tag;
+
+                subset_tags[state] =
+                    tag < T ? static_cast<unsigned char>(tag) : tables_type::no_tag;
+            }
+
+            // minimization by partition refinement, starting with one partition per tag
+            std::array<std::size_t, max_subsets> partition{ };
+            std::size_t partition_count = 0;
+
+            for (std::size_t state = 0; state < subset_count; ++state)
+                partition[state] = subset_tags[state];
+
+            for (;;)
+            {
+                std::array<std::size_t, max_subsets> refined{ };
+                std::size_t refined_count = 0;
+
+                for (std::size_t state = 0; state < subset_count; ++state)
+                {
+                    std::size_t equal = 0;
+
+                    for (; equal < state; ++equal)
+                    {
+                        auto same = partition[equal] == partition[state];
+
+                        for (std::size_t cls = 0; same && cls < class_count; ++cls)
+                        {
+                            same = partition[subset_transitions[equal * K + cls]] ==
+                                partition[subset_transitions[state * K + cls]];
+                        }
+
+                        if (same)
+                            break;
+                    }
+
+                    refined[state] = equal < state ? refined[equal] : refined_count++;
+                }
+
+                const auto stable = refined_count == partition_count;
+
+                partition = refined;
+                partition_count = refined_count;
+
+                if (stable)
+                    break;
+            }
+
+            if (partition_count > S)
+                throw regex_too_complex{};
+
+            // Partitions are numbered by their first member, hence the dead state's partition is
+            // partition 0.
+            tables_type tables{ };
+
+            tables.classes = classes;
+            tables.state_count = partition_count;
+            tables.class_count = class_count;
+            tables.start = static_cast<unsigned char>(partition[1]);
+
+            for (std::size_t state = 0; state < subset_count; ++state)
+            {
+                const auto target = partition[state];
+
+                tables.tags[target] = subset_tags[state];
+
+                for (std::size_t cls = 0; cls < class_count; ++cls)
+                {
+                    tables.transitions[target * K + cls] = static_cast<unsigned char>(
+                        partition[subset_transitions[state * K + cls]]);
+                }
+            }
+
+            return tables;
+        }
+
+        template <std::size_t S, std::size_t K, std::size_t P>
+        constexpr auto compile_regex(const char* pattern, std::size_t size)
+        {
+            regex_parser<P> parser;
+
+            const auto root = parser.parse(pattern, size);
+
+            std::array<regex_position_set<P + 1>, 1> lasts{ root.last };
+
+            if (root.nullable)
+                lasts[0].insert(parser.position_count());
+
+            const auto tables = build_dfa<S, K>(parser, lasts, root.first);
+
+            regex_dfa<S, K> dfa{ };
+
+            dfa.classes = tables.classes;
+            dfa.transitions = tables.transitions;
+            dfa.state_count = tables.state_count;
+            dfa.class_count = tables.class_count;
+            dfa.start = tables.start;
+
+            for (std::size_t state = 0; state < S; ++state)
+                dfa.accepting[state] = tables.tags[state] != tables.no_tag;
+
+            return dfa;
+        }
+
+        constexpr std::size_t default_regex_capacity(std::size_t size) noexcept
+        {
+            return 2 * size + 2 < 256 ? 2 * size + 2 : 256;
+        }
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // regular expression factories
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // S is the maximum number of states of the minimized DFA and K the maximum number of byte
+    // classes. Quantifiers with large counts may require to raise the defaults.
+    template <std::size_t S, std::size_t K, std::size_t N>
+    constexpr auto regex(const char (&pattern)[N])
+    {
+        return detail::compile_regex<S, K, 4 * N>(pattern, N - 1);
+    }
+
+    template <std::size_t N>
+    constexpr auto regex(const char (&pattern)[N])
+    {
+        constexpr auto capacity = detail::default_regex_capacity(N);
+
+        return regex<capacity, capacity>(pattern);
+    }
+
+}
+
+
+#endif /*__REGEX_HPP__*/
@@ -0,0 +1,273 @@
+#ifndef __RESUMABLE_HPP__
+#define __RESUMABLE_HPP__
+
+
+// Resumable parsing of input arriving in fragments, e.g. network frames. Instead of reporting the
+// end of the input at the end of a fragment, fragment sources throw incomplete_input. The entry
+// being parsed is abandoned then and its characters are carried over to the next fragment, where
+// parsing resumes at the start of the entry. Neither the entries parsed before nor the whole input
+// have to be kept.
+//
+//   whirl::resumable_parser parser{ read_entry };
+//
+//   parser.feed(fragment, [](auto entry) { ... });  // for every fragment
+//   parser.finish([](auto entry) { ... });          // at the end of the input
+
+
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "whirl.hpp"
+
+
+namespace whirl
+{
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // fragment sources
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // Thrown by looking at the end of a fragment, which isn't the last one.
+    struct incomplete_input { };
+
+    // The characters carried over from the previous fragments followed by the current fragment.
+    // Fragment sources aren't contiguous, as bulk scans would mistake the end of a fragment for the
+    // end of the input.
+    template <typename C = char>
+    class fragment_source
+    {
+
+        static_assert(is_character_type_v<C>);
+
+    public:
+
+        using view_type = std::basic_string_view<C>;
+
+
+        constexpr fragment_source(view_type carry, view_type fragment, bool last) noexcept
+            : m_first{ carry.empty() ? fragment : carry }
+            , m_second{ carry.empty() ? view_type{ } : fragment }
+            , m_last{ last }
+        { }
+
+        constexpr C look_ahead() const
+        {
+            if (m_first.empty())
+                return this->boundary(static_cast<C>(view_type::traits_type::eof()));
+
+            return m_first.front();
+        }
+
+        constexpr void ignore() noexcept
+        {
+            if (m_first.empty())
+                return;
+
+            m_first.remove_prefix(1);
+
+            if (m_first.empty())
+                std::swap(m_first, m_second);
+        }
+
+        constexpr bool at_end() const
+        {
+            return m_first.empty() && this->boundary(true);
+        }
+
+        // the characters not consumed yet
+        std::basic_string<C> remaining() const
+        {
+            std::basic_string<C> result{ m_first };
+
+            result += m_second;
+
+            return result;
+        }
+
+    private:
+
+        template <typename T>
+        constexpr T boundary(T at_end) const
+        {
+            if (!m_last)
+                throw incomplete_input{ };
+
+            return at_end;
+        }
+
+        // the second part is only used after the first one is consumed
+        view_type m_first;
+        view_type m_second;
+        bool m_last;
+
+    };
+
+    template <typename C>
+    struct input_source_traits<fragment_source<C>>
+    {
+        using char_type = C;
+
+        static constexpr char_type look_ahead(fragment_source<C>& ins)
+        {
+            return ins.look_ahead();
+        }
+
+        static constexpr char_type read(fragment_source<C>& ins)
+        {
+            const auto chr = ins.look_ahead();
+
+            ins.ignore();
+
+            return chr;
+        }
+
+        static constexpr void ignore(fragment_source<C>& ins)
+        {
+            ins.ignore();
+        }
+
+        static constexpr bool is_end(fragment_source<C>& ins)
+        {
+            return ins.at_end();
+        }
+    };
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // resumable parsers
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // Parses entries separated by at least one separator character with parser(ins, pos) and
+    // passes them to emit. The saved state between two fragments consists of the characters of
+    // the incomplete entry and the code position of its start.
+    //
+    // The parser is restarted at the start of an incomplete entry, hence it must not have side
+    // effects beyond its result. As an entry ends at a separator or at the end of the input, the
+    // restart is deferred until a fragment containing a separator arrives, so entries spanning
+    // many fragments aren't parsed again for every fragment. An unexpected_input error is final.
+    template <typename F, typename P = std::decay_t<decltype(space)>, typename C = char>
+    class resumable_parser
+    {
+
+        static_assert(is_bound_predicate_v<P>);
+
+    public:
+
+        using view_type = std::basic_string_view<C>;
+        using value_type = std::decay_t<
+            std::invoke_result_t<const F&, fragment_source<C>&, code_position&>>;
+
+
+        constexpr explicit resumable_parser(
+            const F& parser, const P& separator = space, code_position pos = { 1, 1 })
+            : m_parser{ parser }
+            , m_separator{ separator }
+            , m_pos{ pos }
+        { }
+
+        // Calls emit(value_type) for every entry completed by the fragment.
+        template <typename E>
+        void feed(view_type fragment, E&& emit)
+        {
+            this->parse(fragment, false, emit);
+        }
+
+        // Ends the input and calls emit for the entry carried over, if any. Afterwards the parser
+        // accepts a new input starting at the current position.
+        template <typename E>
+        void finish(E&& emit)
+        {
+            this->parse(view_type{ }, true, emit);
+        }
+
+        // the position after the last complete entry
+        const code_position& position() const noexcept
+        {
+            return m_pos;
+        }
+
+        // the number of characters carried over to the next fragment
+        std::size_t carried() const noexcept
+        {
+            return m_carry.size();
+        }
+
+    private:
+
+        // whether the fragment contains a separator, which may end the carried entry
+        bool may_end_entry(view_type fragment) const
+        {
+            for (const auto chr : fragment)
+            {
+                character_probe<C> probe{ chr, false };
+
+                if (m_separator.is(probe))
+                    return true;
+            }
+
+            return false;
+        }
+
+        template <typename E>
+        void parse(view_type fragment, bool last, E& emit)
+        {
+            if (!last && !m_carry.empty() && !this->may_end_entry(fragment))
+            {
+                m_carry += fragment;
+                return;
+            }
+
+            fragment_source<C> ins{ m_carry, fragment, last };
+
+            for (;;)
+            {
+                try
+                {
+                    next_while(ins, m_pos, m_separator);
+
+                    if (ins.at_end())
+                        break;
+                }
+                catch (const incomplete_input&)
+                {
+                    // the separators are consumed, nothing has to be carried over
+                    break;
+                }
+
+                const auto entry_ins = ins;
+                const auto entry_pos = m_pos;
+
+                try
+                {
+                    auto value = m_parser(ins, m_pos);
+
+                    if (!ins.at_end() && !m_separator.is(ins))
+                        throw unexpected_input{ };
+
+                    emit(std::move(value));
+                }
+                catch (const incomplete_input&)
+                {
+                    m_pos = entry_pos;
+                    m_carry = entry_ins.remaining();
+
+                    return;
+                }
+            }
+
+            m_carry.clear();
+        }
+
+        F m_parser;
+        P m_separator;
+        code_position m_pos;
+        std::basic_string<C> m_carry;
+
+    };
+
+}
+
+
+#endif /*__RESUMABLE_HPP__*/
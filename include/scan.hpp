@@ -0,0 +1,285 @@
+#ifndef __SCAN_HPP__
+#define __SCAN_HPP__
+
+
+// Bulk classification of contiguous char buffers. A class of code units is derived once from a
+// bound predicate and then applied to 64 characters at a time, yielding one bit per character.
+// Small classes, e.g. whitespace or a single delimiter, are matched with SSE2 comparisons, all
+// other classes with a lookup table. Code unit classes are bound predicates as well, which
+// consumers recognize to scan contiguous sources in blocks, e.g. next_while(ins, pos, cls).
+
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+#include "whirl.hpp"
+#include "character_set.hpp"
+
+
+namespace whirl
+{
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // code unit classes
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    class code_unit_class
+    {
+
+    public:
+
+        // the maximum number of members, or non-members, matched by comparison instead of table
+        // lookup
+        static constexpr std::size_t max_compared = 8;
+
+        // the number of characters classified at once
+        static constexpr std::size_t block_size = 64;
+
+
+        // Classes with few non-members, e.g. everything but delimiters, are compared against the
+        // non-members.
+        constexpr explicit code_unit_class(const character_set& set) noexcept
+            : m_table{ }
+            , m_members{ }
+            , m_member_count{ 0 }
+            , m_inverted{ false }
+        {
+            std::size_t count = 0;
+
+            for (std::size_t idx = 0; idx < character_set::domain_size; ++idx)
+            {
+                m_table[idx] = set.contains(idx);
+                count += m_table[idx];
+            }
+
+            m_inverted = count > character_set::domain_size / 2;
+
+            if (m_inverted)
+                count = character_set::domain_size - count;
+
+            if (count > max_compared)
+            {
+                m_member_count = max_compared + 1;
+                return;
+            }
+
+            for (std::size_t idx = 0; idx < character_set::domain_size; ++idx)
+            {
+                if (m_table[idx] != m_inverted)
+                    m_members[m_member_count++] = static_cast<unsigned char>(idx);
+            }
+        }
+
+        template <typename P, typename = requires_t<is_bound_predicate<P>>>
+        constexpr explicit code_unit_class(const P& pred) noexcept
+            : code_unit_class{ character_set::of(pred) }
+        { }
+
+        constexpr bool contains(unsigned char unit) const noexcept
+        {
+            return m_table[unit];
+        }
+
+        // Code unit classes are bound predicates as well. Neither the end nor code units beyond
+        // 255 belong to a class.
+        template <typename I, typename = requires_t<is_input_source_type<I>>>
+        constexpr bool is(I& ins) const
+        {
+            if (input_source_traits<I>::is_end(ins))
+                return false;
+
+            const auto unit = code_unit(input_source_traits<I>::look_ahead(ins));
+
+            if constexpr (sizeof(unit) > 1)
+            {
+                if (unit >= character_set::domain_size)
+                    return false;
+            }
+
+            return m_table[unit];
+        }
+
+        // Bit i of the result is set if first[i] belongs to the class. Exactly block_size
+        // characters have to be readable.
+        std::uint64_t mask(const char* first) const noexcept
+        {
+        #if defined(__SSE2__)
+            if (m_member_count <= max_compared)
+                return this->compare(first);
+        #endif
+
+            return this->lookup(first, block_size);
+        }
+
+        // Like mask, but for count < block_size characters. The bits beyond count are set to fill.
+        std::uint64_t mask(const char* first, std::size_t count, bool fill) const noexcept
+        {
+            const auto tail = fill ? ~std::uint64_t{ 0 } << count : std::uint64_t{ 0 };
+
+            return this->lookup(first, count) | tail;
+        }
+
+    private:
+
+        std::uint64_t lookup(const char* first, std::size_t count) const noexcept
+        {
+            std::uint64_t bits = 0;
+
+            for (std::size_t idx = 0; idx < count; ++idx)
+                bits |= std::uint64_t{ m_table[code_unit(first[idx])] } << idx;
+
+            return bits;
+        }
+
+    #if defined(__SSE2__)
+        std::uint64_t compare(const char* first) const noexcept
+        {
+            std::uint64_t bits = 0;
+
+            for (std::size_t part = 0; part < block_size / 16; ++part)
+            {
+                const auto chars = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(first + part * 16));
+
+                auto matches = _mm_setzero_si128();
+
+                for (std::size_t idx = 0; idx < m_member_count; ++idx)
+                {
+                    matches = _mm_or_si128(matches, _mm_cmpeq_epi8(
+                        chars, _mm_set1_epi8(static_cast<char>(m_members[idx]))));
+                }
+
+                bits |= std::uint64_t{
+                    static_cast<std::uint16_t>(_mm_movemask_epi8(matches))
+                } << (part * 16);
+            }
+
+            return m_inverted ? ~bits : bits;
+        }
+    #endif
+
+        std::array<bool, character_set::domain_size> m_table;
+        std::array<unsigned char, max_compared> m_members;
+        std::size_t m_member_count;
+        bool m_inverted;
+
+    };
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // bit scanning
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // the index of the lowest set bit of a non-zero mask
+    inline unsigned lowest_bit(std::uint64_t bits) noexcept
+    {
+    #if defined(__GNUC__)
+        return static_cast<unsigned>(__builtin_ctzll(bits));
+    #else
+        unsigned idx = 0;
+
+        for (; !(bits & 1); bits >>= 1)
+            ++idx;
+
+        return idx;
+    #endif
+    }
+
+    inline unsigned bit_count(std::uint64_t bits) noexcept
+    {
+    #if defined(__GNUC__)
+        return static_cast<unsigned>(__builtin_popcountll(bits));
+    #else
+        unsigned count = 0;
+
+        for (; bits; bits &= bits - 1)
+            ++count;
+
+        return count;
+    #endif
+    }
+
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // block scanning
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    namespace detail
+    {
+        // the number of leading characters of a buffer satisfying the predicate
+        template <typename C, typename P>
+        std::size_t match_length(const C* first, std::size_t size, const P& pred)
+        {
+            if constexpr (std::is_same_v<P, code_unit_class> && sizeof(C) == 1)
+            {
+                constexpr auto block_size = code_unit_class::block_size;
+
+                const auto chars = reinterpret_cast<const char*>(first);
+
+                std::size_t count = 0;
+
+                for (; count + block_size <= size; count += block_size)
+                {
+                    if (const auto misses = ~pred.mask(chars + count))
+                        return count + lowest_bit(misses);
+                }
+
+                // the bits beyond the buffer are misses
+                return count + lowest_bit(~pred.mask(chars + count, size - count, false));
+            }
+            else
+            {
+                return run_length(first, size, pred);
+            }
+        }
+    }
+
+    // The runs of code unit classes are scanned in blocks on contiguous sources.
+    template <typename I, typename = requires_t<is_input_source_type<I>>>
+    void next_while(I& ins, const code_unit_class& pred)
+    {
+        if constexpr (is_contiguous_input_source_type_v<I>)
+        {
+            using traits = input_source_traits<I>;
+
+            traits::advance(ins, detail::match_length(traits::data(ins), traits::size(ins), pred));
+        }
+        else
+        {
+            while (pred.is(ins))
+                next(ins);
+        }
+    }
+
+    template <typename I, typename = requires_t<is_input_source_type<I>>>
+    void next_while(I& ins, code_position& pos, const code_unit_class& pred)
+    {
+        if constexpr (is_contiguous_input_source_type_v<I>)
+        {
+            using traits = input_source_traits<I>;
+
+            const auto first = traits::data(ins);
+            const auto count = detail::match_length(first, traits::size(ins), pred);
+
+            detail::advance_over(
+                pos, pred, std::basic_string_view<typename traits::char_type>{ first, count });
+            traits::advance(ins, count);
+        }
+        else
+        {
+            while (pred.is(ins))
+                next(ins, pos);
+        }
+    }
+
+}
+
+
+#endif /*__SCAN_HPP__*/
@@ -0,0 +1,311 @@
+#ifndef __SKIP_HPP__
+#define __SKIP_HPP__
+
+
+// Skipping whitespace and comments between tokens in a single loop, instead of alternating
+// next_while(ins, space) with hand written comment loops. Line comments run up to the end of the
+// line, block comments up to their terminator.
+//
+//   const auto skip = whirl::skip(whirl::space, "#", "/*", "*/");
+//
+//   skip(ins, pos);
+//
+// On contiguous char sources whitespace is scanned by a code unit class 64 characters at a time,
+// and comment terminators are searched with memchr or SSE2. Other sources have to be rewindable,
+// e.g. a replay_source, if a comment delimiter has more than one character, otherwise skipping
+// throws std::logic_error before consuming anything. Sources of other character types need a
+// skipper of that type, e.g. skip<char16_t>(space, u"#").
+
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+#include "whirl.hpp"
+#include "scan.hpp"
+#include "lexeme.hpp"
+#include "delimiter.hpp"
+
+
+namespace whirl
+{
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // skippers
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // Skips whitespace, satisfying the predicate, and comments. Empty comment delimiters disable
+    // the respective kind of comment. Block comment delimiters are both empty or neither, else
+    // std::logic_error is thrown. The delimiters have to outlive the skipper. Throws
+    // unexpected_input for a block comment without terminator.
+    template <typename P, typename C = char>
+    class skipper
+    {
+
+        static_assert(is_bound_predicate_v<P>);
+        static_assert(is_character_type_v<C>);
+
+    public:
+
+        using view_type = std::basic_string_view<C>;
+
+
+        explicit skipper(
+            const P& space,
+            view_type line_comment = { },
+            view_type block_open = { },
+            view_type block_close = { })
+            : m_space{ space }
+            , m_class{ space }
+            , m_line_comment{ line_comment }
+            , m_block_open{ block_open }
+            , m_block_close{ block_close }
+        {
+            if (block_open.empty() != block_close.empty())
+                throw std::logic_error{ "block comments need both delimiters or neither" };
+        }
+
+        template <typename I, typename = requires_t<is_input_source_type<I>>>
+        void operator()(I& ins) const
+        {
+            this->skip(ins, nullptr);
+        }
+
+        template <typename I, typename = requires_t<is_input_source_type<I>>>
+        void operator()(I& ins, code_position& pos) const
+        {
+            this->skip(ins, &pos);
+        }
+
+    private:
+
+        template <typename I>
+        void skip(I& ins, code_position* pos) const
+        {
+            static_assert(std::is_same_v<typename input_source_traits<I>::char_type, C>,
+                "the skipper has to be created for the character type of the source, "
+                "e.g. skip<char16_t>(...)");
+
+            if constexpr (is_contiguous_input_source_type_v<I>)
+            {
+                this->skip_contiguous(ins, pos);
+            }
+            else
+            {
+                if constexpr (!is_rewindable_input_source_type_v<I>)
+                {
+                    const auto longest = std::max(
+                        { m_line_comment.size(), m_block_open.size(), m_block_close.size() });
+
+                    if (longest > 1)
+                    {
+                        throw std::logic_error{
+                            "comment delimiters of several characters need a rewindable source" };
+                    }
+                }
+
+                this->skip_streamed(ins, pos);
+            }
+        }
+
+        template <typename I>
+        void skip_contiguous(I& ins, code_position* pos) const
+        {
+            using traits = input_source_traits<I>;
+
+            const auto first = traits::data(ins);
+            const auto size = traits::size(ins);
+
+            std::size_t count = 0;
+
+            for (;;)
+            {
+                count += this->space_length(first + count, size - count);
+
+                const view_type rest{ first + count, size - count };
+
+                if (starts_with(rest, m_line_comment))
+                {
+                    count += detail::find_one_of(rest.data(), rest.size(), C('\n'));
+                }
+                else if (starts_with(rest, m_block_open))
+                {
+                    const auto body = rest.substr(m_block_open.size());
+                    const auto length = detail::find_delimiter(
+                        body.data(), body.size(), m_block_close);
+
+                    if (length == body.size())
+                    {
+                        this->consume(ins, pos, view_type{ first, size });
+                        throw unexpected_input{ };
+                    }
+
+                    count += m_block_open.size() + length + m_block_close.size();
+                }
+                else
+                {
+                    break;
+                }
+            }
+
+            this->consume(ins, pos, view_type{ first, count });
+        }
+
+        template <typename I>
+        void skip_streamed(I& ins, code_position* pos) const
+        {
+            using traits = input_source_traits<I>;
+
+            const auto consume_one = [&ins, pos]() {
+                if (traits::is_end(ins))
+                    throw unexpected_input{ };
+
+                return pos ? next(ins, *pos, as_is) : next(ins, as_is);
+            };
+
+            for (;;)
+            {
+                while (!traits::is_end(ins) && m_space.is(ins))
+                    consume_one();
+
+                if (this->skip_opener(ins, pos, m_line_comment))
+                {
+                    while (!traits::is_end(ins) && traits::look_ahead(ins) != C('\n'))
+                        consume_one();
+                }
+                else if (this->skip_opener(ins, pos, m_block_open))
+                {
+                    while (!this->skip_opener(ins, pos, m_block_close))
+                        consume_one();
+                }
+                else
+                {
+                    break;
+                }
+            }
+        }
+
+        // Consumes the opener if it's next, otherwise nothing.
+        template <typename I>
+        bool skip_opener(I& ins, code_position* pos, view_type opener) const
+        {
+            using traits = input_source_traits<I>;
+
+            if (opener.empty() || traits::is_end(ins) || traits::look_ahead(ins) != opener[0])
+                return false;
+
+            if (opener.size() == 1)
+            {
+                pos ? next(ins, *pos) : next(ins);
+                return true;
+            }
+
+            // skip() rejects longer delimiters for sources that can't rewind
+            if constexpr (is_rewindable_input_source_type_v<I>)
+            {
+                const auto mark = traits::mark(ins);
+                const auto saved_pos = pos ? *pos : code_position{ };
+
+                for (const auto chr : opener)
+                {
+                    if (traits::is_end(ins) || traits::look_ahead(ins) != chr)
+                    {
+                        traits::rewind(ins, mark);
+
+                        if (pos)
+                            *pos = saved_pos;
+
+                        return false;
+                    }
+
+                    pos ? next(ins, *pos) : next(ins);
+                }
+            }
+
+            return true;
+        }
+
+        // The whitespace between most tokens is short, hence it's looked up character by
+        // character first, and scanned in blocks only if it's longer.
+        std::size_t space_length(const C* first, std::size_t size) const noexcept
+        {
+            constexpr std::size_t short_run = 16;
+
+            const auto limit = std::min(size, short_run);
+
+            std::size_t length = 0;
+
+            while (length < limit && this->is_space(first[length]))
+                ++length;
+
+            if (length == short_run)
+                length += detail::match_length(first + length, size - length, m_class);
+
+            return length;
+        }
+
+        bool is_space(C chr) const noexcept
+        {
+            if constexpr (sizeof(C) == 1)
+                return m_class.contains(code_unit(chr));
+            else
+                return satisfies(m_space, chr);
+        }
+
+        template <typename I>
+        static void consume(I& ins, code_position* pos, view_type text)
+        {
+            if (pos)
+                pos->advance(text);
+
+            input_source_traits<I>::advance(ins, text.size());
+        }
+
+        static bool starts_with(view_type text, view_type prefix) noexcept
+        {
+            return !prefix.empty() && text.size() >= prefix.size()
+                && text[0] == prefix[0] && text.compare(0, prefix.size(), prefix) == 0;
+        }
+
+        P m_space;
+
+        // the whitespace scanned in blocks, if possible
+        std::conditional_t<sizeof(C) == 1, code_unit_class, P> m_class;
+
+        view_type m_line_comment;
+        view_type m_block_open;
+        view_type m_block_close;
+
+    };
+
+    template <typename P, typename = requires_t<is_bound_predicate<P>>>
+    auto skip(
+        const P& space,
+        std::string_view line_comment = { },
+        std::string_view block_open = { },
+        std::string_view block_close = { })
+    {
+        return skipper<P>{ space, line_comment, block_open, block_close };
+    }
+
+    // skippers for sources of other character types, e.g. skip<char16_t>(space, u"#")
+    template <
+        typename C,
+        typename P,
+        typename = requires_t<is_character_type<C>, is_bound_predicate<P>>
+    >
+    auto skip(
+        const P& space,
+        std::basic_string_view<C> line_comment = { },
+        std::basic_string_view<C> block_open = { },
+        std::basic_string_view<C> block_close = { })
+    {
+        return skipper<P, C>{ space, line_comment, block_open, block_close };
+    }
+
+}
+
+
+#endif /*__SKIP_HPP__*/
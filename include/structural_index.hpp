@@ -0,0 +1,277 @@
+#ifndef __STRUCTURAL_INDEX_HPP__
+#define __STRUCTURAL_INDEX_HPP__
+
+
+// Two-phase reading of delimiter separated data. The first phase classifies the whole buffer in
+// blocks of 64 characters and records where tokens begin and end. The second phase converts the
+// tokens one by one, without looking at the separators again.
+//
+//   const auto index = whirl::structural_index(text, whirl::space);
+//
+//   for (const auto token : index)
+//       std::string_view ins = token; ...
+
+
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#include "whirl.hpp"
+#include "scan.hpp"
+
+
+namespace whirl
+{
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // structural indices
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // The boundaries of the maximal runs of non-separator characters of a buffer. Offsets are
+    // stored as 32 bit integers, which limits the buffer size to 4 GiB. The buffer isn't copied and
+    // has to outlive the index.
+    class structural_index
+    {
+
+    public:
+
+        using offset_type = std::uint32_t;
+
+
+        class const_iterator
+        {
+
+        public:
+
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = std::string_view;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = std::string_view;
+
+
+            const_iterator() noexcept = default;
+
+            const_iterator(const structural_index* index, std::size_t idx) noexcept
+                : m_index{ index }
+                , m_idx{ idx }
+            { }
+
+            std::string_view operator*() const noexcept
+            {
+                return m_index->token(m_idx);
+            }
+
+            const_iterator& operator++() noexcept
+            {
+                ++m_idx;
+                return *this;
+            }
+
+            const_iterator operator++(int) noexcept
+            {
+                auto tmp = *this;
+                ++m_idx;
+                return tmp;
+            }
+
+            const_iterator& operator--() noexcept
+            {
+                --m_idx;
+                return *this;
+            }
+
+            const_iterator operator--(int) noexcept
+            {
+                auto tmp = *this;
+                --m_idx;
+                return tmp;
+            }
+
+            const_iterator& operator+=(difference_type count) noexcept
+            {
+                m_idx += count;
+                return *this;
+            }
+
+            const_iterator& operator-=(difference_type count) noexcept
+            {
+                m_idx -= count;
+                return *this;
+            }
+
+            friend const_iterator operator+(const_iterator it, difference_type count) noexcept
+            {
+                return it += count;
+            }
+
+            friend const_iterator operator-(const_iterator it, difference_type count) noexcept
+            {
+                return it -= count;
+            }
+
+            friend difference_type operator-(
+                const const_iterator& lhs, const const_iterator& rhs) noexcept
+            {
+                return static_cast<difference_type>(lhs.m_idx) -
+                    static_cast<difference_type>(rhs.m_idx);
+            }
+
+            std::string_view operator[](difference_type count) const noexcept
+            {
+                return *(*this + count);
+            }
+
+            friend bool operator==(const const_iterator& lhs, const const_iterator& rhs) noexcept
+            {
+                return lhs.m_idx == rhs.m_idx;
+            }
+
+            friend bool operator!=(const const_iterator& lhs, const const_iterator& rhs) noexcept
+            {
+                return lhs.m_idx != rhs.m_idx;
+            }
+
+            friend bool operator<(const const_iterator& lhs, const const_iterator& rhs) noexcept
+            {
+                return lhs.m_idx < rhs.m_idx;
+            }
+
+            friend bool operator>(const const_iterator& lhs, const const_iterator& rhs) noexcept
+            {
+                return lhs.m_idx > rhs.m_idx;
+            }
+
+            friend bool operator<=(const const_iterator& lhs, const const_iterator& rhs) noexcept
+            {
+                return lhs.m_idx <= rhs.m_idx;
+            }
+
+            friend bool operator>=(const const_iterator& lhs, const const_iterator& rhs) noexcept
+            {
+                return lhs.m_idx >= rhs.m_idx;
+            }
+
+        private:
+
+            const structural_index* m_index = nullptr;
+            std::size_t m_idx = 0;
+
+        };
+
+
+        // Separators are given as a bound predicate. It is evaluated once per code unit, not once
+        // per character of the buffer.
+        template <typename P, typename = requires_t<is_bound_predicate<P>>>
+        structural_index(std::string_view text, const P& separator)
+            : structural_index{ text, code_unit_class{ separator } }
+        { }
+
+        structural_index(std::string_view text, const code_unit_class& separator)
+            : m_text{ text }
+        {
+            if (text.size() >= std::numeric_limits<offset_type>::max())
+                throw std::length_error{ "structural index buffer exceeds 4 GiB" };
+
+            this->build(separator);
+        }
+
+        // the number of tokens
+        std::size_t size() const noexcept
+        {
+            return m_boundaries.size() / 2;
+        }
+
+        bool empty() const noexcept
+        {
+            return m_boundaries.empty();
+        }
+
+        std::size_t offset(std::size_t idx) const noexcept
+        {
+            return m_boundaries[2 * idx];
+        }
+
+        std::size_t length(std::size_t idx) const noexcept
+        {
+            return m_boundaries[2 * idx + 1] - m_boundaries[2 * idx];
+        }
+
+        std::string_view token(std::size_t idx) const noexcept
+        {
+            return m_text.substr(this->offset(idx), this->length(idx));
+        }
+
+        std::string_view text() const noexcept
+        {
+            return m_text;
+        }
+
+        const_iterator begin() const noexcept
+        {
+            return const_iterator{ this, 0 };
+        }
+
+        const_iterator end() const noexcept
+        {
+            return const_iterator{ this, this->size() };
+        }
+
+    private:
+
+        void build(const code_unit_class& separator)
+        {
+            constexpr auto block_size = code_unit_class::block_size;
+
+            const auto size = m_text.size();
+
+            // typical data has tokens of a few characters
+            m_boundaries.reserve(size / 4 + 2);
+
+            // the position before the buffer counts as separator
+            std::uint64_t carry = 1;
+
+            for (std::size_t base = 0; base < size; base += block_size)
+            {
+                const auto separators = size - base >= block_size ?
+                    separator.mask(m_text.data() + base) :
+                    separator.mask(m_text.data() + base, size - base, true);
+
+                // bit i is set if the character before i is a separator
+                const auto preceded = (separators << 1) | carry;
+
+                auto boundaries = separators ^ preceded;
+
+                if (boundaries)
+                {
+                    auto count = m_boundaries.size();
+
+                    m_boundaries.resize(count + bit_count(boundaries));
+
+                    for (; boundaries; boundaries &= boundaries - 1)
+                    {
+                        m_boundaries[count++] =
+                            static_cast<offset_type>(base + lowest_bit(boundaries));
+                    }
+                }
+
+                carry = separators >> (block_size - 1);
+            }
+
+            // a token reaching the end of a buffer of whole blocks is still open
+            if (m_boundaries.size() % 2)
+                m_boundaries.push_back(static_cast<offset_type>(size));
+        }
+
+        std::string_view m_text;
+        std::vector<offset_type> m_boundaries;
+
+    };
+
+}
+
+
+#endif /*__STRUCTURAL_INDEX_HPP__*/
@@ -0,0 +1,330 @@
+#ifndef __THREAD_POOL_HPP__
+#define __THREAD_POOL_HPP__
+
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+
+namespace whirl
+{
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // thread pools
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // A fixed number of worker threads sharing one task queue. Tasks are started in the order of
+    // submission. The destructor finishes all pending tasks before joining the workers.
+    class thread_pool
+    {
+
+    public:
+
+        explicit thread_pool(std::size_t thread_count = std::thread::hardware_concurrency())
+        {
+            thread_count = std::max<std::size_t>(thread_count, 1);
+
+            m_threads.reserve(thread_count);
+
+            for (std::size_t idx = 0; idx < thread_count; ++idx)
+                m_threads.emplace_back([this]() { this->work(); });
+        }
+
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator=(const thread_pool&) = delete;
+
+        ~thread_pool()
+        {
+            {
+                std::lock_guard<std::mutex> lock{ m_mutex };
+                m_stopping = true;
+            }
+
+            m_wakeup.notify_all();
+
+            for (auto& thread : m_threads)
+                thread.join();
+        }
+
+        std::size_t size() const noexcept
+        {
+            return m_threads.size();
+        }
+
+        // Exceptions thrown by the task are rethrown by the returned future.
+        template <typename F>
+        auto submit(F&& func)
+        {
+            using result_type = std::invoke_result_t<std::decay_t<F>&>;
+
+            auto task = std::make_shared<std::packaged_task<result_type()>>(std::forward<F>(func));
+            auto result = task->get_future();
+
+            {
+                std::lock_guard<std::mutex> lock{ m_mutex };
+                m_tasks.emplace_back([task]() { (*task)(); });
+            }
+
+            m_wakeup.notify_one();
+
+            return result;
+        }
+
+        template <typename T>
+        void wait(const std::future<T>& result) const
+        {
+            result.wait();
+        }
+
+    private:
+
+        void work()
+        {
+            for (;;)
+            {
+                std::function<void()> task;
+
+                {
+                    std::unique_lock<std::mutex> lock{ m_mutex };
+
+                    m_wakeup.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+
+                    if (m_tasks.empty())
+                        return;
+
+                    task = std::move(m_tasks.front());
+                    m_tasks.pop_front();
+                }
+
+                task();
+            }
+        }
+
+        std::mutex m_mutex;
+        std::condition_variable m_wakeup;
+        std::deque<std::function<void()>> m_tasks;
+        std::vector<std::thread> m_threads;
+        bool m_stopping = false;
+
+    };
+
+
+    // Every worker owns a task deque. A worker runs its own tasks newest first, then the tasks
+    // submitted from other threads in order and finally steals the oldest tasks of other workers.
+    // Tasks submitted by a worker go to its own deque, hence a large task splitting itself into
+    // subtasks shares them with idle workers. Waiting for a future with wait() on a worker runs
+    // other tasks meanwhile, so tasks may wait for their subtasks without blocking the worker.
+    class work_stealing_pool
+    {
+
+    public:
+
+        explicit work_stealing_pool(std::size_t thread_count = std::thread::hardware_concurrency())
+        {
+            thread_count = std::max<std::size_t>(thread_count, 1);
+
+            for (std::size_t idx = 0; idx < thread_count; ++idx)
+                m_queues.push_back(std::make_unique<task_queue>());
+
+            m_threads.reserve(thread_count);
+
+            for (std::size_t idx = 0; idx < thread_count; ++idx)
+                m_threads.emplace_back([this, idx]() { this->work(idx); });
+        }
+
+        work_stealing_pool(const work_stealing_pool&) = delete;
+        work_stealing_pool& operator=(const work_stealing_pool&) = delete;
+
+        ~work_stealing_pool()
+        {
+            {
+                std::lock_guard<std::mutex> lock{ m_sleep_mutex };
+                m_stopping = true;
+            }
+
+            m_wakeup.notify_all();
+
+            for (auto& thread : m_threads)
+                thread.join();
+        }
+
+        std::size_t size() const noexcept
+        {
+            return m_threads.size();
+        }
+
+        // Exceptions thrown by the task are rethrown by the returned future.
+        template <typename F>
+        auto submit(F&& func)
+        {
+            using result_type = std::invoke_result_t<std::decay_t<F>&>;
+
+            auto task = std::make_shared<std::packaged_task<result_type()>>(std::forward<F>(func));
+            auto result = task->get_future();
+
+            const auto self = this->current_worker();
+            auto& queue = self == no_worker ? m_injected : *m_queues[self];
+
+            // Counted before being published, as a worker may take the task right away and the
+            // count must not drop below zero. Workers seeing the count early just look again.
+            m_pending.fetch_add(1, std::memory_order_release);
+
+            try
+            {
+                std::lock_guard<std::mutex> lock{ queue.mutex };
+                queue.tasks.emplace_back([task]() { (*task)(); });
+            }
+            catch (...)
+            {
+                m_pending.fetch_sub(1, std::memory_order_relaxed);
+                throw;
+            }
+
+            // a worker between checking for pending tasks and sleeping would miss the notification
+            {
+                std::lock_guard<std::mutex> lock{ m_sleep_mutex };
+            }
+
+            m_wakeup.notify_one();
+
+            return result;
+        }
+
+        // Runs other tasks until the result is ready, if called by a worker of the pool.
+        template <typename T>
+        void wait(const std::future<T>& result)
+        {
+            const auto self = this->current_worker();
+
+            if (self == no_worker)
+                return result.wait();
+
+            while (result.wait_for(std::chrono::seconds{ 0 }) != std::future_status::ready)
+            {
+                if (!this->run_one(self))
+                    std::this_thread::yield();
+            }
+        }
+
+    private:
+
+        static constexpr auto no_worker = static_cast<std::size_t>(-1);
+
+        struct task_queue
+        {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        struct worker_identity
+        {
+            const work_stealing_pool* pool;
+            std::size_t index;
+        };
+
+        static worker_identity& identity() noexcept
+        {
+            thread_local worker_identity id{ nullptr, no_worker };
+
+            return id;
+        }
+
+        std::size_t current_worker() const noexcept
+        {
+            const auto& id = identity();
+
+            return id.pool == this ? id.index : no_worker;
+        }
+
+        static bool pop_back(task_queue& queue, std::function<void()>& task)
+        {
+            std::lock_guard<std::mutex> lock{ queue.mutex };
+
+            if (queue.tasks.empty())
+                return false;
+
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+
+            return true;
+        }
+
+        static bool pop_front(task_queue& queue, std::function<void()>& task)
+        {
+            std::lock_guard<std::mutex> lock{ queue.mutex };
+
+            if (queue.tasks.empty())
+                return false;
+
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+
+            return true;
+        }
+
+        bool run_one(std::size_t self)
+        {
+            if (m_pending.load(std::memory_order_acquire) == 0)
+                return false;
+
+            std::function<void()> task;
+
+            auto found = pop_back(*m_queues[self], task) || pop_front(m_injected, task);
+
+            for (std::size_t offset = 1; !found && offset < m_queues.size(); ++offset)
+                found = pop_front(*m_queues[(self + offset) % m_queues.size()], task);
+
+            if (!found)
+                return false;
+
+            m_pending.fetch_sub(1, std::memory_order_relaxed);
+
+            task();
+
+            return true;
+        }
+
+        void work(std::size_t idx)
+        {
+            identity() = worker_identity{ this, idx };
+
+            for (;;)
+            {
+                if (this->run_one(idx))
+                    continue;
+
+                std::unique_lock<std::mutex> lock{ m_sleep_mutex };
+
+                m_wakeup.wait(lock, [this]() {
+                    return m_stopping || m_pending.load(std::memory_order_acquire) > 0;
+                });
+
+                if (m_stopping && m_pending.load(std::memory_order_acquire) == 0)
+                    return;
+            }
+        }
+
+        std::vector<std::unique_ptr<task_queue>> m_queues;
+        task_queue m_injected;
+        std::vector<std::thread> m_threads;
+        std::atomic<std::size_t> m_pending{ 0 };
+        std::mutex m_sleep_mutex;
+        std::condition_variable m_wakeup;
+        bool m_stopping = false;
+
+    };
+
+}
+
+
+#endif /*__THREAD_POOL_HPP__*/
@@ -4,6 +4,7 @@
 
 #include <type_traits>
 #include <istream>
+#include <string_view>
 
 namespace whirl
 {
@@ -38,6 +39,16 @@ namespace whirl
     struct are_character_types : std::bool_constant<std::conjunction_v<is_character_type<Ts>...>>
     { };
 
+    // Symbols are what input sources yield: characters, or values of other types opting in by
+    // specializing this trait, e.g. the token kinds of lexers.
+    template <typename T>
+    struct is_symbol_type : is_character_type<T>
+    { };
+
+    template <typename... Ts>
+    struct are_symbol_types : std::bool_constant<std::conjunction_v<is_symbol_type<Ts>...>>
+    { };
+
 
     template <typename T1, typename T2, typename = void>
     struct equality_comparable : std::false_type
@@ -54,8 +65,8 @@ namespace whirl
     struct is_compatible_character_type
         : std::bool_constant<
             std::conjunction_v<
-                is_character_type<T1>,
-                is_character_type<T2>,
+                is_symbol_type<T1>,
+                is_symbol_type<T2>,
                 equality_comparable<T1, T2>
             >
         >
@@ -67,6 +78,12 @@ namespace whirl
     template <typename... Ts>
     constexpr auto are_character_types_v = are_character_types<Ts...>::value;
 
+    template <typename T>
+    constexpr auto is_symbol_type_v = is_symbol_type<T>::value;
+
+    template <typename... Ts>
+    constexpr auto are_symbol_types_v = are_symbol_types<Ts...>::value;
+
     template <typename T1, typename T2>
     constexpr auto is_compatible_character_type_v = is_compatible_character_type<T1, T2>::value;
 
@@ -83,13 +100,13 @@ namespace whirl
 
     template <typename T1, typename T2>
     struct is_input_source_trait_class_type_impl<T1, T2, std::void_t<
-        requires_t<is_character_type<typename T1::char_type>>,
+        requires_t<is_symbol_type<typename T1::char_type>>,
         requires_type_t<decltype(T1::look_ahead(std::declval<T2&>())), typename T1::char_type>,
         requires_type_t<decltype(T1::read(std::declval<T2&>())), typename T1::char_type>,
         requires_type_t<decltype(T1::ignore(std::declval<T2&>())), void>,
         requires_type_t<decltype(T1::is_end(std::declval<T2&>())), bool>
     >>
-        : is_character_type<decltype(T1::read(std::declval<T2&>()))>
+        : is_symbol_type<decltype(T1::read(std::declval<T2&>()))>
     { };
 
     template <typename T>
@@ -121,32 +138,187 @@ namespace whirl
         is_compatible_input_source_type<T1, T2>::value;
 
 
-    template <template <typename...> typename TT, typename T, typename... Ts>
+    // Contiguous input sources additionally expose the remaining characters as an array, which
+    // allows consumers to scan them in bulk and to skip them at once.
+    template <typename T, typename = void>
+    struct is_contiguous_input_source_type : std::false_type { };
+
+    template <typename T>
+    struct is_contiguous_input_source_type<T, std::void_t<
+        requires_t<is_input_source_type<T>>,
+        requires_type_t<
+            decltype(input_source_traits<T>::data(std::declval<T&>())),
+            const typename input_source_traits<T>::char_type*
+        >,
+        requires_type_t<decltype(input_source_traits<T>::size(std::declval<T&>())), std::size_t>,
+        requires_type_t<
+            decltype(input_source_traits<T>::advance(std::declval<T&>(), std::size_t{ })), void
+        >
+    >> : std::true_type
+    { };
+
+    template <typename T>
+    constexpr auto is_contiguous_input_source_type_v = is_contiguous_input_source_type<T>::value;
+
+
+    // Rewindable input sources return a mark of the current position, which they can be rewound to
+    // later on. This allows consumers to try an alternative and back out.
+    template <typename T, typename = void>
+    struct is_rewindable_input_source_type : std::false_type { };
+
+    template <typename T>
+    struct is_rewindable_input_source_type<T, std::void_t<
+        requires_t<is_input_source_type<T>>,
+        requires_type_t<
+            decltype(input_source_traits<T>::mark(std::declval<T&>())),
+            typename input_source_traits<T>::mark_type
+        >,
+        requires_type_t<
+            decltype(input_source_traits<T>::rewind(
+                std::declval<T&>(),
+                std::declval<const typename input_source_traits<T>::mark_type&>()
+            )),
+            void
+        >
+    >> : std::true_type
+    { };
+
+    template <typename T>
+    constexpr auto is_rewindable_input_source_type_v = is_rewindable_input_source_type<T>::value;
+
+
+    // Any stream derived from an input stream, e.g. file and string streams.
+    template <typename T>
     struct input_source_traits<
-        TT<T, Ts...>, requires_t<std::is_base_of<std::basic_istream<T, Ts...>, TT<T, Ts...>>>
+        T, requires_t<std::is_base_of<
+            std::basic_istream<typename T::char_type, typename T::traits_type>, T
+        >>
     >
     {
-        using char_type = T;
-        using stream_type = TT<T, Ts...>;
+        using char_type = typename T::char_type;
+        using stream_type = T;
+        using base_type = std::basic_istream<char_type, typename T::traits_type>;
 
-        static char_type look_ahead(std::basic_istream<T, Ts...>& ins)
+        static char_type look_ahead(base_type& ins)
         {
             return ins.peek();
         }
 
-        static char_type read(std::basic_istream<T, Ts...>& ins)
+        static char_type read(base_type& ins)
         {
             return ins.get();
         }
 
-        static void ignore(std::basic_istream<T, Ts...>& ins)
+        static void ignore(base_type& ins)
         {
-            return ins.ignore();
+            ins.ignore();
         }
 
-        static auto is_end(std::basic_istream<T, Ts...>& ins)
+        static auto is_end(base_type& ins)
         {
-            return ins.peek() == std::char_traits<T>::eof();
+            return ins.peek() == T::traits_type::eof();
+        }
+    };
+
+    // A string view is consumed by removing characters from its front. Marking it is copying it.
+    template <typename T, typename... Ts>
+    struct input_source_traits<std::basic_string_view<T, Ts...>>
+    {
+        using char_type = T;
+        using view_type = std::basic_string_view<T, Ts...>;
+        using mark_type = view_type;
+
+        static constexpr char_type look_ahead(view_type& ins) noexcept
+        {
+            if (ins.empty())
+                return static_cast<char_type>(view_type::traits_type::eof());
+
+            return ins.front();
+        }
+
+        static constexpr char_type read(view_type& ins) noexcept
+        {
+            const auto chr = look_ahead(ins);
+
+            ignore(ins);
+
+            return chr;
+        }
+
+        static constexpr void ignore(view_type& ins) noexcept
+        {
+            if (!ins.empty())
+                ins.remove_prefix(1);
+        }
+
+        static constexpr bool is_end(view_type& ins) noexcept
+        {
+            return ins.empty();
+        }
+
+        static constexpr const char_type* data(view_type& ins) noexcept
+        {
+            return ins.data();
+        }
+
+        static constexpr std::size_t size(view_type& ins) noexcept
+        {
+            return ins.size();
+        }
+
+        static constexpr void advance(view_type& ins, std::size_t count) noexcept
+        {
+            ins.remove_prefix(count);
+        }
+
+        static constexpr mark_type mark(view_type& ins) noexcept
+        {
+            return ins;
+        }
+
+        static constexpr void rewind(view_type& ins, const mark_type& mark) noexcept
+        {
+            ins = mark;
+        }
+    };
+
+
+    // An input source consisting of exactly one look ahead character or the virtual end token. It
+    // is used to evaluate bound predicates on a single character, e.g. at compile time.
+    template <typename C>
+    struct character_probe
+    {
+
+        static_assert(is_symbol_type_v<C>);
+
+
+        C chr;
+        bool end;
+
+    };
+
+    template <typename C>
+    struct input_source_traits<character_probe<C>>
+    {
+        using char_type = C;
+
+        static constexpr char_type look_ahead(character_probe<C>& ins) noexcept
+        {
+            return ins.chr;
+        }
+
+        static constexpr char_type read(character_probe<C>& ins) noexcept
+        {
+            return ins.chr;
+        }
+
+        static constexpr void ignore(character_probe<C>&) noexcept
+        {
+        }
+
+        static constexpr bool is_end(character_probe<C>& ins) noexcept
+        {
+            return ins.end;
         }
     };
 
@@ -174,6 +346,11 @@ namespace whirl
             : std::true_type
         {};
 
+        // Symbol types other than characters have no stream type. Their headers specialize this
+        // trait to probe predicates with a character_probe instead.
+        template <typename T, typename = void>
+        struct is_bound_symbol_predicate_impl : std::false_type {};
+
     }
 
     template <typename T>
@@ -182,7 +359,8 @@ namespace whirl
             detail::is_bound_predicate_impl<T, char>,
             detail::is_bound_predicate_impl<T, wchar_t>,
             detail::is_bound_predicate_impl<T, char16_t>,
-            detail::is_bound_predicate_impl<T, char32_t>
+            detail::is_bound_predicate_impl<T, char32_t>,
+            detail::is_bound_symbol_predicate_impl<T>
         >
     {};
 
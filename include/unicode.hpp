@@ -0,0 +1,771 @@
+#ifndef __UNICODE_HPP__
+#define __UNICODE_HPP__
+
+
+// Decoding input sources, which read encoded text and expose its code points as char32_t, so
+// parsers for UTF-32 work on UTF-8 and UTF-16 input without converting it up front. Malformed
+// input is detected while decoding and reported as invalid_encoding, which is an unexpected_input.
+//
+//   whirl::utf8_source ins(text);
+//
+//   whirl::next_while(ins, pos, whirl::space);
+//
+// UTF-8 is validated or transcoded up front by validate_utf8 and to_utf32, or validated on the fly
+// by validating_utf8_source, which still reads code units and supports bulk scans.
+
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+#include "whirl.hpp"
+#include "scan.hpp"
+
+
+namespace whirl
+{
+
+    // the offset of the first code unit of the malformed sequence
+    struct invalid_encoding : unexpected_input
+    {
+        std::size_t offset;
+    };
+
+    namespace detail
+    {
+        [[noreturn]] inline void throw_invalid_encoding(std::size_t offset)
+        {
+            invalid_encoding error;
+
+            error.offset = offset;
+
+            throw error;
+        }
+    }
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // UTF-8 decoding
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    namespace detail
+    {
+        // Decodes the code point at the start of a non-empty buffer. Returns the length of its
+        // sequence, or zero if the sequence is malformed, overlong, truncated, a surrogate or
+        // beyond U+10FFFF.
+        inline std::size_t decode_utf8(
+            const unsigned char* first, const unsigned char* last, char32_t& code_point) noexcept
+        {
+            const auto lead = first[0];
+
+            if (lead < 0x80)
+            {
+                code_point = lead;
+                return 1;
+            }
+
+            std::size_t length;
+
+            // the range of the second code unit excludes overlong forms and surrogates
+            unsigned char lower = 0x80;
+            unsigned char upper = 0xBF;
+
+            if (lead < 0xC2)
+            {
+                return 0;
+            }
+            else if (lead < 0xE0)
+            {
+                length = 2;
+                code_point = lead & 0x1F;
+            }
+            else if (lead < 0xF0)
+            {
+                length = 3;
+                code_point = lead & 0x0F;
+                lower = lead == 0xE0 ? 0xA0 : lower;
+                upper = lead == 0xED ? 0x9F : upper;
+            }
+            else if (lead < 0xF5)
+            {
+                length = 4;
+                code_point = lead & 0x07;
+                lower = lead == 0xF0 ? 0x90 : lower;
+                upper = lead == 0xF4 ? 0x8F : upper;
+            }
+            else
+            {
+                return 0;
+            }
+
+            if (static_cast<std::size_t>(last - first) < length)
+                return 0;
+
+            for (std::size_t idx = 1; idx < length; ++idx)
+            {
+                const auto unit = first[idx];
+
+                if (unit < lower || unit > upper)
+                    return 0;
+
+                lower = 0x80;
+                upper = 0xBF;
+                code_point = (code_point << 6) | (unit & 0x3F);
+            }
+
+            return length;
+        }
+
+        // the end of the run of ASCII code units at the start of a buffer
+        inline const unsigned char* ascii_run_end(
+            const unsigned char* first, const unsigned char* last) noexcept
+        {
+        #if defined(__SSE2__)
+            for (; last - first >= 16; first += 16)
+            {
+                const auto units = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+
+                // the most significant bit marks non-ASCII code units
+                if (const auto mask = _mm_movemask_epi8(units))
+                    return first + lowest_bit(static_cast<std::uint64_t>(mask));
+            }
+        #endif
+
+            while (first != last && *first < 0x80)
+                ++first;
+
+            return first;
+        }
+    }
+
+    // Decodes UTF-8 one code point at a time from a buffer, which has to outlive the source. The
+    // code point ahead is decoded when the previous one is consumed, hence looking ahead needs no
+    // checks, and runs of ASCII characters are detected 16 bytes at a time and need no decoding.
+    // Malformed input is reported when it becomes the look ahead, by the constructor or ignore.
+    // Marking the source is copying it.
+    class utf8_source
+    {
+
+    public:
+
+        using char_type = char32_t;
+
+        // the number of bytes checked for ASCII at once
+        static constexpr std::size_t ascii_scan_size = 256;
+
+
+        explicit utf8_source(std::string_view text)
+            : m_first{ reinterpret_cast<const unsigned char*>(text.data()) }
+            , m_pos{ m_first }
+            , m_ascii_end{ m_first }
+            , m_end{ m_first + text.size() }
+        {
+            this->decode();
+        }
+
+        char32_t look_ahead() const noexcept
+        {
+            return m_current;
+        }
+
+        void ignore()
+        {
+            m_pos += m_length;
+
+            if (m_pos < m_ascii_end)
+                m_current = *m_pos;
+            else
+                this->decode();
+        }
+
+        bool at_end() const noexcept
+        {
+            return m_pos == m_end;
+        }
+
+        // the number of bytes consumed
+        std::size_t offset() const noexcept
+        {
+            return static_cast<std::size_t>(m_pos - m_first);
+        }
+
+    private:
+
+        // Decodes the code point at the current position outside of an ASCII run. Starts a new
+        // ASCII run, if the code point is ASCII.
+        void decode()
+        {
+            if (m_pos == m_end)
+            {
+                m_current = static_cast<char32_t>(std::char_traits<char32_t>::eof());
+                m_length = 0;
+                return;
+            }
+
+            if (*m_pos < 0x80)
+            {
+                const auto scan_end = static_cast<std::size_t>(m_end - m_pos) > ascii_scan_size
+                    ? m_pos + ascii_scan_size
+                    : m_end;
+
+                m_ascii_end = detail::ascii_run_end(m_pos, scan_end);
+                m_current = *m_pos;
+                m_length = 1;
+                return;
+            }
+
+            m_length = detail::decode_utf8(m_pos, m_end, m_current);
+
+            if (m_length == 0)
+            {
+                // the malformed sequence can't be consumed, but reported again
+                m_current = U'\uFFFD';
+
+                detail::throw_invalid_encoding(this->offset());
+            }
+        }
+
+        const unsigned char* m_first;
+        const unsigned char* m_pos;
+        const unsigned char* m_ascii_end;
+        const unsigned char* m_end;
+
+        // the code point at the current position and the length of its sequence
+        char32_t m_current = 0;
+        std::size_t m_length = 0;
+
+    };
+
+    template <>
+    struct input_source_traits<utf8_source>
+    {
+        using char_type = char32_t;
+        using mark_type = utf8_source;
+
+        static char_type look_ahead(utf8_source& ins) noexcept
+        {
+            return ins.look_ahead();
+        }
+
+        static char_type read(utf8_source& ins)
+        {
+            const auto chr = ins.look_ahead();
+
+            ins.ignore();
+
+            return chr;
+        }
+
+        static void ignore(utf8_source& ins)
+        {
+            ins.ignore();
+        }
+
+        static bool is_end(utf8_source& ins) noexcept
+        {
+            return ins.at_end();
+        }
+
+        static mark_type mark(utf8_source& ins) noexcept
+        {
+            return ins;
+        }
+
+        static void rewind(utf8_source& ins, const mark_type& mark) noexcept
+        {
+            ins = mark;
+        }
+    };
+
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // UTF-8 validation and transcoding
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    namespace detail
+    {
+        // Validates the sequences starting before a position, the last one may extend beyond it.
+        // Returns the end of the last sequence, or the start of the first malformed one, which is
+        // before the position.
+        inline const unsigned char* validate_utf8(
+            const unsigned char* first, const unsigned char* until, const unsigned char* last)
+            noexcept
+        {
+            for (;;)
+            {
+                first = ascii_run_end(first, until);
+
+                if (first >= until)
+                    return first;
+
+                char32_t code_point;
+
+                const auto length = decode_utf8(first, last, code_point);
+
+                if (length == 0)
+                    return first;
+
+                first += length;
+            }
+        }
+
+        // Widens a run of ASCII code units to code points.
+        inline char32_t* widen_ascii(
+            const unsigned char* first, const unsigned char* last, char32_t* out) noexcept
+        {
+        #if defined(__SSE2__)
+            const auto zero = _mm_setzero_si128();
+
+            for (; last - first >= 16; first += 16, out += 16)
+            {
+                const auto units = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+                const auto low = _mm_unpacklo_epi8(units, zero);
+                const auto high = _mm_unpackhi_epi8(units, zero);
+
+                const auto dest = reinterpret_cast<__m128i*>(out);
+
+                _mm_storeu_si128(dest + 0, _mm_unpacklo_epi16(low, zero));
+                _mm_storeu_si128(dest + 1, _mm_unpackhi_epi16(low, zero));
+                _mm_storeu_si128(dest + 2, _mm_unpacklo_epi16(high, zero));
+                _mm_storeu_si128(dest + 3, _mm_unpackhi_epi16(high, zero));
+            }
+        #endif
+
+            while (first != last)
+                *out++ = *first++;
+
+            return out;
+        }
+    }
+
+    // Checks a whole buffer for malformed UTF-8 up front, e.g. an upload before parsing it with a
+    // string view as source. Runs of ASCII are skipped 16 bytes at a time.
+    inline void validate_utf8(std::string_view text)
+    {
+        const auto first = reinterpret_cast<const unsigned char*>(text.data());
+        const auto last = first + text.size();
+
+        const auto invalid = detail::validate_utf8(first, last, last);
+
+        if (invalid != last)
+            detail::throw_invalid_encoding(static_cast<std::size_t>(invalid - first));
+    }
+
+    // Transcodes a whole buffer to UTF-32, e.g. to parse it with a u32string_view as source.
+    // Malformed input is reported as invalid_encoding. Runs of ASCII are widened 16 bytes at a
+    // time.
+    inline std::u32string to_utf32(std::string_view text)
+    {
+        // every code unit yields at most one code point
+        std::u32string result(text.size(), U'\0');
+
+        const auto first = reinterpret_cast<const unsigned char*>(text.data());
+        const auto last = first + text.size();
+
+        auto pos = first;
+        auto out = result.data();
+
+        while (pos != last)
+        {
+            const auto run_end = detail::ascii_run_end(pos, last);
+
+            out = detail::widen_ascii(pos, run_end, out);
+            pos = run_end;
+
+            if (pos == last)
+                break;
+
+            const auto length = detail::decode_utf8(pos, last, *out);
+
+            if (length == 0)
+                detail::throw_invalid_encoding(static_cast<std::size_t>(pos - first));
+
+            pos += length;
+            ++out;
+        }
+
+        result.resize(static_cast<std::size_t>(out - result.data()));
+
+        return result;
+    }
+
+    // Reads UTF-8 code units from a buffer, which has to outlive the source, and validates them as
+    // they are consumed. It is contiguous like a string view, hence bulk scans, e.g. by
+    // next_while_view, and validation make a single pass over the buffer: validation follows the
+    // position in blocks, and a malformed sequence in the block reached is reported as
+    // invalid_encoding before the characters consumed are returned. Marking the source is copying
+    // it.
+    class validating_utf8_source
+    {
+
+    public:
+
+        using char_type = char;
+
+        // the number of bytes validated ahead of the position at once
+        static constexpr std::size_t validation_block_size = 64;
+
+
+        explicit validating_utf8_source(std::string_view text)
+            : m_first{ reinterpret_cast<const unsigned char*>(text.data()) }
+            , m_pos{ m_first }
+            , m_validated{ m_first }
+            , m_end{ m_first + text.size() }
+        {
+            this->validate();
+        }
+
+        char look_ahead() const noexcept
+        {
+            if (m_pos == m_end)
+                return static_cast<char>(std::char_traits<char>::eof());
+
+            return static_cast<char>(*m_pos);
+        }
+
+        void advance(std::size_t count)
+        {
+            m_pos += count;
+
+            if (m_pos >= m_validated && m_validated != m_end)
+                this->validate();
+        }
+
+        bool at_end() const noexcept
+        {
+            return m_pos == m_end;
+        }
+
+        const char* data() const noexcept
+        {
+            return reinterpret_cast<const char*>(m_pos);
+        }
+
+        std::size_t size() const noexcept
+        {
+            return static_cast<std::size_t>(m_end - m_pos);
+        }
+
+        // the number of bytes consumed
+        std::size_t offset() const noexcept
+        {
+            return static_cast<std::size_t>(m_pos - m_first);
+        }
+
+    private:
+
+        // Validates everything consumed and the block following the position.
+        void validate()
+        {
+            const auto until = static_cast<std::size_t>(m_end - m_pos) > validation_block_size
+                ? m_pos + validation_block_size
+                : m_end;
+
+            const auto reached = detail::validate_utf8(m_validated, until, m_end);
+
+            if (reached < until)
+                detail::throw_invalid_encoding(static_cast<std::size_t>(reached - m_first));
+
+            m_validated = reached;
+        }
+
+        const unsigned char* m_first;
+        const unsigned char* m_pos;
+        const unsigned char* m_validated;
+        const unsigned char* m_end;
+
+    };
+
+    template <>
+    struct input_source_traits<validating_utf8_source>
+    {
+        using char_type = char;
+        using mark_type = validating_utf8_source;
+
+        static char_type look_ahead(validating_utf8_source& ins) noexcept
+        {
+            return ins.look_ahead();
+        }
+
+        static char_type read(validating_utf8_source& ins)
+        {
+            const auto chr = ins.look_ahead();
+
+            ignore(ins);
+
+            return chr;
+        }
+
+        static void ignore(validating_utf8_source& ins)
+        {
+            if (!ins.at_end())
+                ins.advance(1);
+        }
+
+        static bool is_end(validating_utf8_source& ins) noexcept
+        {
+            return ins.at_end();
+        }
+
+        static const char_type* data(validating_utf8_source& ins) noexcept
+        {
+            return ins.data();
+        }
+
+        static std::size_t size(validating_utf8_source& ins) noexcept
+        {
+            return ins.size();
+        }
+
+        static void advance(validating_utf8_source& ins, std::size_t count)
+        {
+            ins.advance(count);
+        }
+
+        static mark_type mark(validating_utf8_source& ins) noexcept
+        {
+            return ins;
+        }
+
+        static void rewind(validating_utf8_source& ins, const mark_type& mark) noexcept
+        {
+            ins = mark;
+        }
+    };
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // UTF-16 decoding
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    namespace detail
+    {
+        constexpr bool is_surrogate(char16_t unit) noexcept
+        {
+            return (unit & 0xF800) == 0xD800;
+        }
+
+        constexpr bool is_high_surrogate(char16_t unit) noexcept
+        {
+            return (unit & 0xFC00) == 0xD800;
+        }
+
+        constexpr bool is_low_surrogate(char16_t unit) noexcept
+        {
+            return (unit & 0xFC00) == 0xDC00;
+        }
+
+        // Decodes the code point at the start of a non-empty buffer. Returns the length of its
+        // sequence, or zero if it is a lone surrogate.
+        inline std::size_t decode_utf16(
+            const char16_t* first, const char16_t* last, char32_t& code_point) noexcept
+        {
+            if (!is_surrogate(first[0]))
+            {
+                code_point = first[0];
+                return 1;
+            }
+
+            if (!is_high_surrogate(first[0]) || last - first < 2 || !is_low_surrogate(first[1]))
+                return 0;
+
+            code_point = 0x10000 + ((char32_t{ first[0] } - 0xD800) << 10)
+                + (char32_t{ first[1] } - 0xDC00);
+
+            return 2;
+        }
+
+        // the end of the run of code units other than surrogates at the start of a buffer
+        inline const char16_t* bmp_run_end(const char16_t* first, const char16_t* last) noexcept
+        {
+        #if defined(__SSE2__)
+            const auto surrogate_mask = _mm_set1_epi16(static_cast<short>(0xF800));
+            const auto surrogate_bits = _mm_set1_epi16(static_cast<short>(0xD800));
+
+            for (; last - first >= 8; first += 8)
+            {
+                const auto units = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+                const auto surrogates = _mm_cmpeq_epi16(
+                    _mm_and_si128(units, surrogate_mask), surrogate_bits);
+
+                // two mask bits per code unit
+                if (const auto mask = _mm_movemask_epi8(surrogates))
+                    return first + lowest_bit(static_cast<std::uint64_t>(mask)) / 2;
+            }
+        #endif
+
+            while (first != last && !is_surrogate(*first))
+                ++first;
+
+            return first;
+        }
+    }
+
+    // Decodes UTF-16 one code point at a time from a buffer, which has to outlive the source, and
+    // combines surrogate pairs. Works like utf8_source, runs without surrogates are detected 8 code
+    // units at a time and need no decoding. A validating source reports lone surrogates as
+    // invalid_encoding, with the offset counted in code units. A trusting source is meant for
+    // input known to be well-formed and doesn't check what follows a high surrogate.
+    template <bool validating>
+    class basic_utf16_source
+    {
+
+    public:
+
+        using char_type = char32_t;
+
+        // the number of code units checked for surrogates at once
+        static constexpr std::size_t bmp_scan_size = 256;
+
+
+        explicit basic_utf16_source(std::u16string_view text)
+            : m_first{ text.data() }
+            , m_pos{ m_first }
+            , m_bmp_end{ m_first }
+            , m_end{ m_first + text.size() }
+        {
+            this->decode();
+        }
+
+        char32_t look_ahead() const noexcept
+        {
+            return m_current;
+        }
+
+        void ignore()
+        {
+            m_pos += m_length;
+
+            if (m_pos < m_bmp_end)
+                m_current = *m_pos;
+            else
+                this->decode();
+        }
+
+        bool at_end() const noexcept
+        {
+            return m_pos == m_end;
+        }
+
+        // the number of code units consumed
+        std::size_t offset() const noexcept
+        {
+            return static_cast<std::size_t>(m_pos - m_first);
+        }
+
+    private:
+
+        // Decodes the code point at the current position outside of a run without surrogates.
+        // Starts a new run, if the code point isn't a surrogate.
+        void decode()
+        {
+            if (m_pos == m_end)
+            {
+                m_current = static_cast<char32_t>(std::char_traits<char32_t>::eof());
+                m_length = 0;
+                return;
+            }
+
+            if (!detail::is_surrogate(*m_pos))
+            {
+                const auto scan_end = static_cast<std::size_t>(m_end - m_pos) > bmp_scan_size
+                    ? m_pos + bmp_scan_size
+                    : m_end;
+
+                m_bmp_end = detail::bmp_run_end(m_pos, scan_end);
+                m_current = *m_pos;
+                m_length = 1;
+                return;
+            }
+
+            if constexpr (validating)
+            {
+                m_length = detail::decode_utf16(m_pos, m_end, m_current);
+
+                if (m_length == 0)
+                {
+                    // the lone surrogate can't be consumed, but reported again
+                    m_current = U'\uFFFD';
+
+                    detail::throw_invalid_encoding(this->offset());
+                }
+            }
+            else if (detail::is_high_surrogate(*m_pos) && m_end - m_pos >= 2)
+            {
+                // the low surrogate is taken for granted
+                m_current = 0x10000 + ((char32_t{ m_pos[0] } - 0xD800) << 10)
+                    + (char32_t{ m_pos[1] } - 0xDC00);
+                m_length = 2;
+            }
+            else
+            {
+                m_current = *m_pos;
+                m_length = 1;
+            }
+        }
+
+        const char16_t* m_first;
+        const char16_t* m_pos;
+        const char16_t* m_bmp_end;
+        const char16_t* m_end;
+
+        // the code point at the current position and the length of its sequence
+        char32_t m_current = 0;
+        std::size_t m_length = 0;
+
+    };
+
+    using utf16_source = basic_utf16_source<true>;
+    using trusted_utf16_source = basic_utf16_source<false>;
+
+    template <bool validating>
+    struct input_source_traits<basic_utf16_source<validating>>
+    {
+        using char_type = char32_t;
+        using mark_type = basic_utf16_source<validating>;
+
+        static char_type look_ahead(basic_utf16_source<validating>& ins) noexcept
+        {
+            return ins.look_ahead();
+        }
+
+        static char_type read(basic_utf16_source<validating>& ins)
+        {
+            const auto chr = ins.look_ahead();
+
+            ins.ignore();
+
+            return chr;
+        }
+
+        static void ignore(basic_utf16_source<validating>& ins)
+        {
+            ins.ignore();
+        }
+
+        static bool is_end(basic_utf16_source<validating>& ins) noexcept
+        {
+            return ins.at_end();
+        }
+
+        static mark_type mark(basic_utf16_source<validating>& ins) noexcept
+        {
+            return ins;
+        }
+
+        static void rewind(basic_utf16_source<validating>& ins, const mark_type& mark) noexcept
+        {
+            ins = mark;
+        }
+    };
+
+}
+
+
+#endif /*__UNICODE_HPP__*/
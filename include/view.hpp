@@ -0,0 +1,271 @@
+#ifndef __VIEW_HPP__
+#define __VIEW_HPP__
+
+
+// Lazy, single pass ranges of the entries of an input source. An entry is read on every increment
+// only, hence algorithms terminating early, e.g. std::find_if or std::copy_n, leave the rest of
+// the input unread.
+//
+//   for (const auto value : whirl::parse_view(ins, read_value))
+//       ...
+//
+// Entries are separated by at least one separator character. Leading and trailing separators are
+// skipped.
+
+
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+
+#include "whirl.hpp"
+
+
+namespace whirl
+{
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // parsed ranges
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    // The parser is called as parser(ins, pos), if the range tracks a code position, or else as
+    // parser(ins) if possible. Parsers taking no code position track one on contiguous sources
+    // only, by advancing it over the consumed characters. The range refers to the input source and
+    // the code position, which have to outlive it. Iterators of one range share the current entry.
+    template <typename I, typename F, typename P>
+    class parsed_range
+    {
+
+        static_assert(is_input_source_type_v<I>);
+        static_assert(is_bound_predicate_v<P>);
+
+        static constexpr bool is_position_free = std::is_invocable_v<const F&, I&>;
+        static constexpr bool is_position_aware = std::is_invocable_v<const F&, I&, code_position&>;
+
+        static_assert(
+            is_position_free || is_position_aware,
+            "the parser has to be callable as parser(ins) or parser(ins, pos)");
+
+    public:
+
+        using value_type = std::decay_t<typename std::conditional_t<
+            is_position_free,
+            std::invoke_result<const F&, I&>,
+            std::invoke_result<const F&, I&, code_position&>
+        >::type>;
+
+
+        class iterator
+        {
+
+        public:
+
+            using iterator_category = std::input_iterator_tag;
+            using value_type = typename parsed_range::value_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const value_type*;
+            using reference = const value_type&;
+
+
+            // keeps the entry of an iterator incremented by postfix increment
+            class postfix_proxy
+            {
+
+            public:
+
+                explicit postfix_proxy(value_type value)
+                    : m_value{ std::move(value) }
+                { }
+
+                const value_type& operator*() const noexcept
+                {
+                    return m_value;
+                }
+
+            private:
+
+                value_type m_value;
+
+            };
+
+
+            // the end iterator
+            iterator() noexcept = default;
+
+            explicit iterator(parsed_range* range)
+                : m_range{ range }
+            {
+                if (!m_range->advance())
+                    m_range = nullptr;
+            }
+
+            reference operator*() const noexcept
+            {
+                return *m_range->m_current;
+            }
+
+            pointer operator->() const noexcept
+            {
+                return &*m_range->m_current;
+            }
+
+            iterator& operator++()
+            {
+                if (!m_range->advance())
+                    m_range = nullptr;
+
+                return *this;
+            }
+
+            postfix_proxy operator++(int)
+            {
+                postfix_proxy previous{ **this };
+
+                ++*this;
+
+                return previous;
+            }
+
+            friend bool operator==(const iterator& lhs, const iterator& rhs) noexcept
+            {
+                return lhs.m_range == rhs.m_range;
+            }
+
+            friend bool operator!=(const iterator& lhs, const iterator& rhs) noexcept
+            {
+                return lhs.m_range != rhs.m_range;
+            }
+
+        private:
+
+            parsed_range* m_range = nullptr;
+
+        };
+
+
+        constexpr parsed_range(I& ins, code_position* pos, const F& parser, const P& separator)
+            : m_ins{ &ins }
+            , m_pos{ pos }
+            , m_parser{ parser }
+            , m_separator{ separator }
+        { }
+
+        // Reads the first entry. Calling begin a second time continues with the next entry.
+        iterator begin()
+        {
+            return iterator{ this };
+        }
+
+        iterator end() const noexcept
+        {
+            return iterator{ };
+        }
+
+    private:
+
+        // Reads the next entry. Returns false at the end of the input.
+        bool advance()
+        {
+            auto& ins = *m_ins;
+
+            if (m_current && !m_separator.is(ins) && !is(ins, whirl::end))
+                throw unexpected_input{ };
+
+            if (m_pos)
+                next_while(ins, *m_pos, m_separator);
+            else
+                next_while(ins, m_separator);
+
+            if (is(ins, whirl::end))
+            {
+                m_current.reset();
+                return false;
+            }
+
+            if (m_pos)
+                m_current.emplace(this->parse_tracked(ins, *m_pos));
+            else if constexpr (is_position_free)
+                m_current.emplace(m_parser(ins));
+            else
+                m_current.emplace(m_parser(ins, m_dummy_pos));
+
+            return true;
+        }
+
+        value_type parse_tracked(I& ins, code_position& pos) const
+        {
+            if constexpr (is_position_aware)
+            {
+                return m_parser(ins, pos);
+            }
+            else if constexpr (is_contiguous_input_source_type_v<I>)
+            {
+                using traits = input_source_traits<I>;
+                using view_type = std::basic_string_view<typename traits::char_type>;
+
+                const auto first = traits::data(ins);
+
+                auto value = m_parser(ins);
+
+                const auto count = static_cast<std::size_t>(traits::data(ins) - first);
+
+                pos.advance(view_type{ first, count });
+
+                return value;
+            }
+            else
+            {
+                // rejected by parse_view, the position can't be tracked
+                return m_parser(ins);
+            }
+        }
+
+        I* m_ins;
+        code_position* m_pos;
+        F m_parser;
+        P m_separator;
+        code_position m_dummy_pos{ 1, 1 };
+        std::optional<value_type> m_current;
+
+    };
+
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+    // parsed range factories
+    ////////////////////////////////////////////////////////////////////////////////////////////////
+
+    template <
+        typename I,
+        typename F,
+        typename P = std::decay_t<decltype(space)>,
+        typename = requires_t<is_input_source_type<I>>,
+        typename = requires_t<is_bound_predicate<P>>
+    >
+    constexpr auto parse_view(I& ins, const F& parser, const P& separator = space)
+    {
+        return parsed_range<I, F, P>{ ins, nullptr, parser, separator };
+    }
+
+    template <
+        typename I,
+        typename F,
+        typename P = std::decay_t<decltype(space)>,
+        typename = requires_t<is_input_source_type<I>>,
+        typename = requires_t<is_bound_predicate<P>>
+    >
+    constexpr auto parse_view(
+        I& ins, code_position& pos, const F& parser, const P& separator = space)
+    {
+        static_assert(
+            std::is_invocable_v<const F&, I&, code_position&> ||
+                is_contiguous_input_source_type_v<I>,
+            "tracking a code position requires a parser(ins, pos) or a contiguous source");
+
+        return parsed_range<I, F, P>{ ins, &pos, parser, separator };
+    }
+
+}
+
+
+#endif /*__VIEW_HPP__*/
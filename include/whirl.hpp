@@ -2,7 +2,9 @@
 #define __WHIRL_HPP__
 
 
+#include <cstdint>
 #include <istream>
+#include <string_view>
 #include <vector>
 #include <optional>
 #include <algorithm>
@@ -19,26 +21,220 @@ namespace whirl
     // parsing error handling
     ////////////////////////////////////////////////////////////////////////////////////////////////
 
+    // The unit columns are counted in. Counting code points, continuation bytes of UTF-8 and low
+    // surrogates of UTF-16 don't count. Graphemes are approximated by code points, of which
+    // combining marks, joiners, variation selectors and emoji modifiers don't count either. These
+    // are recognized once their last code unit has been counted.
+    enum class column_unit : unsigned char { code_units, code_points, graphemes };
+
+    namespace detail
+    {
+        constexpr bool is_zero_width(std::uint32_t code_point) noexcept
+        {
+            return (code_point >= 0x0300 && code_point <= 0x036F)
+                || (code_point >= 0x1AB0 && code_point <= 0x1AFF)
+                || (code_point >= 0x1DC0 && code_point <= 0x1DFF)
+                || (code_point >= 0x20D0 && code_point <= 0x20FF)
+                || (code_point >= 0xFE00 && code_point <= 0xFE0F)
+                || (code_point >= 0xFE20 && code_point <= 0xFE2F)
+                || (code_point >= 0x1F3FB && code_point <= 0x1F3FF)
+                || (code_point >= 0xE0100 && code_point <= 0xE01EF)
+                || code_point == 0x200D;
+        }
+
+        // Newlines are summed up in blocks, whose narrow sums compilers vectorize.
+        template <typename C>
+        constexpr std::uint64_t count_newlines(const C* first, const C* last) noexcept
+        {
+            constexpr std::ptrdiff_t block_size = 255;
+
+            std::uint64_t count = 0;
+
+            for (; last - first >= block_size; first += block_size)
+            {
+                unsigned char block_count = 0;
+
+                for (std::ptrdiff_t idx = 0; idx < block_size; ++idx)
+                    block_count = static_cast<unsigned char>(block_count + (first[idx] == C('\n')));
+
+                count += block_count;
+            }
+
+            for (; first != last; ++first)
+                count += *first == C('\n');
+
+            return count;
+        }
+    }
+
+    // Rows and columns are 64 bit, as inputs may exceed 4 GB. Columns are counted in code units,
+    // unless another unit is chosen, e.g. code_position{ 1, 1, column_unit::code_points }.
     struct code_position
     {
-        unsigned row;
-        unsigned col;
+        std::uint64_t row;
+        std::uint64_t col;
+        column_unit unit = column_unit::code_units;
 
-        template <typename C, typename = requires_t<is_character_type<C>>>
+        // the code units still missing of a code point counted as grapheme, and its bits so far
+        unsigned char pending_units = 0;
+        std::uint32_t pending_code_point = 0;
+
+        template <typename C, typename = requires_t<is_symbol_type<C>>>
         constexpr void update(C chr) noexcept
         {
-            if (chr == '\n')
+            if constexpr (!is_character_type_v<C>)
+            {
+                // other symbols, e.g. tokens, count as one column each
+                this->col++;
+            }
+            else if (chr == '\n')
             {
                 this->row++;
                 this->col = 0;
+                this->pending_units = 0;
+            }
+            else
+            {
+                this->count_column(chr);
+            }
+        }
+
+        // Same as calling update for every character of a run consumed at once. Only the columns
+        // after the last newline are counted.
+        template <typename C>
+        constexpr void advance(std::basic_string_view<C> text) noexcept
+        {
+            const auto last_newline = text.rfind(C('\n'));
+
+            if (last_newline != std::basic_string_view<C>::npos)
+            {
+                this->row += detail::count_newlines(text.data(), text.data() + last_newline + 1);
+                this->col = 0;
+                this->pending_units = 0;
+
+                text.remove_prefix(last_newline + 1);
+            }
+
+            this->advance_columns(text);
+        }
+
+        // Same as advance for a run known to contain no newline.
+        template <typename C>
+        constexpr void advance_columns(std::basic_string_view<C> text) noexcept
+        {
+            if (this->unit == column_unit::code_units)
+            {
+                this->col += text.size();
             }
             else
+            {
+                for (const auto chr : text)
+                    this->count_column(chr);
+            }
+        }
+
+        // Counts a code unit other than a newline. Leading code units count a column, which a
+        // zero width code point takes back once it's complete.
+        template <typename C>
+        constexpr void count_column(C chr) noexcept
+        {
+            const auto value = static_cast<std::uint32_t>(
+                static_cast<std::make_unsigned_t<C>>(chr));
+            const auto graphemes = this->unit == column_unit::graphemes;
+
+            if (this->unit == column_unit::code_units)
             {
                 this->col++;
             }
+            else if constexpr (sizeof(C) == 1)
+            {
+                if ((value & 0xC0) != 0x80)
+                {
+                    this->col++;
+
+                    if (graphemes)
+                    {
+                        this->pending_units = value >= 0xF0 ? 3 : value >= 0xE0 ? 2 : value >= 0xC0;
+                        this->pending_code_point = value & (0x3F >> this->pending_units);
+                    }
+                }
+                else if (graphemes && this->pending_units > 0)
+                {
+                    this->pending_code_point = (this->pending_code_point << 6) | (value & 0x3F);
+
+                    this->pending_units--;
+
+                    if (!this->pending_units && detail::is_zero_width(this->pending_code_point))
+                        this->col--;
+                }
+            }
+            else if constexpr (sizeof(C) == 2)
+            {
+                if (value < 0xDC00 || value > 0xDFFF)
+                {
+                    this->col++;
+
+                    if (graphemes)
+                    {
+                        this->pending_units = value >= 0xD800 && value <= 0xDBFF;
+                        this->pending_code_point = value;
+
+                        if (!this->pending_units && detail::is_zero_width(value))
+                            this->col--;
+                    }
+                }
+                else if (graphemes && this->pending_units > 0)
+                {
+                    this->pending_units = 0;
+
+                    if (detail::is_zero_width(
+                        0x10000 + ((this->pending_code_point - 0xD800) << 10) + (value - 0xDC00)))
+                    {
+                        this->col--;
+                    }
+                }
+            }
+            else
+            {
+                this->col += !graphemes || !detail::is_zero_width(value);
+            }
         }
     };
 
+    namespace detail
+    {
+        // the number of leading characters of a buffer satisfying the predicate
+        template <typename C, typename P>
+        constexpr std::size_t run_length(const C* first, std::size_t size, const P& pred)
+        {
+            std::size_t count = 0;
+
+            for (; count < size; ++count)
+            {
+                character_probe<C> probe{ first[count], false };
+
+                if (!pred.is(probe))
+                    break;
+            }
+
+            return count;
+        }
+
+        // Updates the position for a run of characters satisfying the predicate. Runs of
+        // predicates rejecting newlines aren't searched for them.
+        template <typename P, typename C>
+        constexpr void advance_over(
+            code_position& pos, const P& pred, std::basic_string_view<C> run)
+        {
+            character_probe<C> newline{ C('\n'), false };
+
+            if (pred.is(newline))
+                pos.advance(run);
+            else
+                pos.advance_columns(run);
+        }
+    }
+
     struct unexpected_input { };
 
 
@@ -46,11 +242,30 @@ namespace whirl
     // basic bound predicates
     ////////////////////////////////////////////////////////////////////////////////////////////////
 
+    namespace detail
+    {
+        // Compares characters of different types by their unsigned values, so '\xE9' matches
+        // U+00E9 of a decoding source, instead of being sign extended.
+        template <typename D, typename C>
+        constexpr bool is_same_character(D chr, C cmp) noexcept
+        {
+            if constexpr (are_character_types_v<D, C> && !std::is_same_v<D, C>)
+            {
+                return static_cast<std::uint_least32_t>(static_cast<std::make_unsigned_t<D>>(chr))
+                    == static_cast<std::uint_least32_t>(static_cast<std::make_unsigned_t<C>>(cmp));
+            }
+            else
+            {
+                return chr == cmp;
+            }
+        }
+    }
+
     template <typename C>
     struct bound_is_predicate
     {
 
-        static_assert(is_character_type_v<C>);
+        static_assert(is_symbol_type_v<C>);
 
 
         explicit constexpr bound_is_predicate(const C& cmp)
@@ -60,7 +275,7 @@ namespace whirl
         template <typename I, typename = requires_t<is_compatible_input_source_type<I, C>>>
         constexpr bool is(I& ins) const
         {
-            return input_source_traits<I>::look_ahead(ins) == this->cmp;
+            return detail::is_same_character(input_source_traits<I>::look_ahead(ins), this->cmp);
         }
 
         C cmp;
@@ -71,7 +286,7 @@ namespace whirl
     struct bound_is_not_predicate
     {
 
-        static_assert(is_character_type_v<C>);
+        static_assert(is_symbol_type_v<C>);
 
 
         explicit constexpr bound_is_not_predicate(const C& cmp)
@@ -81,7 +296,7 @@ namespace whirl
         template <typename I, typename = requires_t<is_compatible_input_source_type<I, C>>>
         constexpr bool is(I& ins) const
         {
-            return input_source_traits<I>::look_ahead(ins) != this->cmp;
+            return !detail::is_same_character(input_source_traits<I>::look_ahead(ins), this->cmp);
         }
 
         C cmp;
@@ -92,7 +307,7 @@ namespace whirl
     struct bound_is_one_of_predicate
     {
 
-        static_assert(are_character_types_v<Cs...>);
+        static_assert(are_symbol_types_v<Cs...>);
 
 
         explicit constexpr bound_is_one_of_predicate(const Cs&... cmps)
@@ -104,7 +319,9 @@ namespace whirl
         {
             return std::apply(
                 [&ins](const auto&... cmps) {
-                    return ((input_source_traits<I>::look_ahead(ins) == cmps) || ...);
+                    const auto chr = input_source_traits<I>::look_ahead(ins);
+
+                    return (detail::is_same_character(chr, cmps) || ...);
                 },
                 this->cmps
             );
@@ -118,7 +335,7 @@ namespace whirl
     struct bound_is_none_of_predicate
     {
 
-        static_assert(are_character_types_v<Cs...>);
+        static_assert(are_symbol_types_v<Cs...>);
 
 
         explicit constexpr bound_is_none_of_predicate(const Cs&... cmps)
@@ -130,7 +347,9 @@ namespace whirl
         {
             return std::apply(
                 [&ins](const auto&... cmps) {
-                    return ((input_source_traits<I>::look_ahead(ins) != cmps) && ...);
+                    const auto chr = input_source_traits<I>::look_ahead(ins);
+
+                    return (!detail::is_same_character(chr, cmps) && ...);
                 },
                 this->cmps
             );
@@ -183,7 +402,7 @@ namespace whirl
         template <typename T>
         constexpr bool is(T& ins) const
         {
-            return this->p1(ins) && this->p2(ins);
+            return this->p1.is(ins) && this->p2.is(ins);
         }
 
         P1 p1;
@@ -207,7 +426,7 @@ namespace whirl
         template <typename I>
         constexpr bool is(I& ins) const
         {
-            return this->pred1(ins) || this->pred2(ins);
+            return this->pred1.is(ins) || this->pred2.is(ins);
         }
 
         P1 pred1;
@@ -229,7 +448,7 @@ namespace whirl
         template <typename I>
         constexpr bool is(I& ins) const
         {
-            return !this->pred(ins);
+            return !this->pred.is(ins);
         }
 
         P pred;
@@ -274,19 +493,19 @@ namespace whirl
     // specialzed optimized logical bound predicate operations
     ////////////////////////////////////////////////////////////////////////////////////////////////
 
-    template <typename C, typename = requires_t<is_character_type<C>>>
+    template <typename C, typename = requires_t<is_symbol_type<C>>>
     constexpr auto operator!(const bound_is_predicate<C>& p)
     {
         return bound_is_not_predicate<C>{ p.cmp };
     }
 
-    template <typename C, typename = requires_t<is_character_type<C>>>
+    template <typename C, typename = requires_t<is_symbol_type<C>>>
     constexpr auto operator!(const bound_is_not_predicate<C>& p)
     {
         return bound_is_predicate<C>{ p.cmp };
     }
 
-    template <typename... Cs, typename = requires_t<are_character_types<Cs...>>>
+    template <typename... Cs, typename = requires_t<are_symbol_types<Cs...>>>
     constexpr auto operator!(const bound_is_one_of_predicate<Cs...>& p)
     {
         return std::apply(
@@ -297,7 +516,7 @@ namespace whirl
         );
     }
 
-    template <typename... Cs, typename = requires_t<are_character_types<Cs...>>>
+    template <typename... Cs, typename = requires_t<are_symbol_types<Cs...>>>
     constexpr auto operator!(const bound_is_none_of_predicate<Cs...>& p)
     {
         return std::apply(
@@ -308,13 +527,13 @@ namespace whirl
         );
     }
 
-    template <typename C1, typename C2, typename = requires_t<are_character_types<C1, C2>>>
+    template <typename C1, typename C2, typename = requires_t<are_symbol_types<C1, C2>>>
     constexpr auto operator||(const bound_is_predicate<C1>& lhs, const bound_is_predicate<C2>& rhs)
     {
         return bound_is_one_of_predicate{ lhs.cmp, rhs.cmp };
     }
 
-    template <typename... Cs, typename C, typename = requires_t<are_character_types<C, Cs...>>>
+    template <typename... Cs, typename C, typename = requires_t<are_symbol_types<C, Cs...>>>
     constexpr auto operator||(
         const bound_is_one_of_predicate<Cs...>& lhs, const bound_is_predicate<C>& rhs
     )
@@ -327,7 +546,7 @@ namespace whirl
         );
     }
 
-    template <typename C, typename... Cs, typename = requires_t<are_character_types<C, Cs...>>>
+    template <typename C, typename... Cs, typename = requires_t<are_symbol_types<C, Cs...>>>
     constexpr auto operator||(
         const bound_is_predicate<C>& lhs, const bound_is_one_of_predicate<Cs...>& rhs
     )
@@ -336,7 +555,7 @@ namespace whirl
     }
 
     template <
-        typename... Cs1, typename... Cs2, typename = requires_t<are_character_types<Cs1..., Cs2...>>
+        typename... Cs1, typename... Cs2, typename = requires_t<are_symbol_types<Cs1..., Cs2...>>
     >
     constexpr auto operator||(
         const bound_is_one_of_predicate<Cs1...>& lhs, const bound_is_one_of_predicate<Cs2...>& rhs
@@ -350,7 +569,7 @@ namespace whirl
         );
     }
 
-    template <typename C1, typename C2, typename = requires_t<are_character_types<C1, C2>>>
+    template <typename C1, typename C2, typename = requires_t<are_symbol_types<C1, C2>>>
     constexpr auto operator&&(
         const bound_is_not_predicate<C1>& lhs, const bound_is_not_predicate<C2>& rhs
     )
@@ -361,8 +580,8 @@ namespace whirl
     template <
         typename... Cs,
         typename C,
-        typename = requires_t<is_character_type<Cs>...>,
-        typename = requires_t<is_character_type<C>>
+        typename = requires_t<is_symbol_type<Cs>...>,
+        typename = requires_t<is_symbol_type<C>>
     >
     constexpr auto operator&&(
         const bound_is_none_of_predicate<Cs...>& lhs, const bound_is_not_predicate<C>& rhs
@@ -376,7 +595,7 @@ namespace whirl
         );
     }
 
-    template <typename C, typename... Cs, typename = requires_t<are_character_types<C, Cs...>>>
+    template <typename C, typename... Cs, typename = requires_t<are_symbol_types<C, Cs...>>>
     constexpr auto operator&&(
         const bound_is_not_predicate<C>& lhs, const bound_is_none_of_predicate<Cs...>& rhs
     )
@@ -385,7 +604,7 @@ namespace whirl
     }
 
     template <
-        typename... Cs1, typename... Cs2, typename = requires_t<are_character_types<Cs1..., Cs2...>>
+        typename... Cs1, typename... Cs2, typename = requires_t<are_symbol_types<Cs1..., Cs2...>>
     >
     constexpr auto operator&&(
         const bound_is_none_of_predicate<Cs1...>& lhs,
@@ -407,7 +626,7 @@ namespace whirl
 
     template <
         typename C,
-        typename = requires_t<is_character_type<C>>
+        typename = requires_t<is_symbol_type<C>>
     >
     constexpr auto is(const C& cmp)
     {
@@ -428,11 +647,11 @@ namespace whirl
         typename I,
         typename C,
         typename = requires_t<is_input_source_type<I>>,
-        typename = requires_t<is_character_type<C>>
+        typename = requires_t<is_symbol_type<C>>
     >
     constexpr auto is(I& ins, const C& cmp)
     {
-        return input_source_traits<I>::look_ahead(ins) != cmp;
+        return detail::is_same_character(input_source_traits<I>::look_ahead(ins), cmp);
     }
 
     template <
@@ -447,19 +666,19 @@ namespace whirl
         return pred.is(ins);
     }
 
-    template <typename C, typename = requires_t<is_character_type<C>>>
+    template <typename C, typename = requires_t<is_symbol_type<C>>>
     constexpr auto is_not(const C& cmp)
     {
         return bound_is_not_predicate{ cmp };
     }
 
-    template <typename... Cs, typename = requires_t<are_character_types<Cs...>>>
+    template <typename... Cs, typename = requires_t<are_symbol_types<Cs...>>>
     constexpr auto is_one_of(const Cs&... cmp)
     {
         return bound_is_one_of_predicate{ cmp... };
     }
 
-    template <typename... Cs, typename = requires_t<are_character_types<Cs...>>>
+    template <typename... Cs, typename = requires_t<are_symbol_types<Cs...>>>
     constexpr auto is_none_of(const Cs&... cmp)
     {
         return bound_is_none_of_predicate{ cmp... };
@@ -499,7 +718,7 @@ namespace whirl
             : res{ std::move(res) }
         { }
 
-        template <typename C, typename = requires_t<is_character_type<C>>>
+        template <typename C, typename = requires_t<is_symbol_type<C>>>
         constexpr auto operator()(const C&) const
         {
             return res;
@@ -510,7 +729,7 @@ namespace whirl
 
     struct as_is_transform
     {
-        template <typename C, typename = requires_t<is_character_type<C>>>
+        template <typename C, typename = requires_t<is_symbol_type<C>>>
         constexpr auto operator()(const C& chr) const
         {
             return chr;
@@ -637,9 +856,12 @@ namespace whirl
     >
     constexpr void next_is(I& ins, const P& pred)
     {
-        if(!pred(ins))
+        if(!pred.is(ins))
             throw unexpected_input{};
 
+        if constexpr(std::is_same_v<P, bound_is_end_predicate>)
+            return;
+
         next(ins);
     }
 
@@ -653,9 +875,12 @@ namespace whirl
     >
     constexpr auto next_is(I& ins, const P& pred, const T& trans)
     {
-        if(!pred(ins))
+        if(!pred.is(ins))
             throw unexpected_input{};
 
+        if constexpr(std::is_same_v<P, bound_is_end_predicate>)
+            return;
+
         return next(ins, trans);
     }
 
@@ -670,7 +895,7 @@ namespace whirl
     >
     constexpr auto next_is(V init, I& ins, const P& pred, const T& trans)
     {
-        if(!pred(ins))
+        if(!pred.is(ins))
             throw unexpected_input{};
 
         return concat(init, next(ins, trans));
@@ -703,7 +928,7 @@ namespace whirl
     >
     constexpr auto next_is(I& ins, code_position& pos, const P& pred, const T& trans)
     {
-        if(!pred(ins))
+        if(!pred.is(ins))
             throw unexpected_input{};
 
         if constexpr(std::is_same_v<P, bound_is_end_predicate>)
@@ -723,7 +948,7 @@ namespace whirl
     >
     constexpr auto next_is(V init, I& ins, code_position& pos, const P& pred, const T& trans)
     {
-        if(!pred(ins))
+        if(!pred.is(ins))
             throw unexpected_input{};
 
         if constexpr(std::is_same_v<P, bound_is_end_predicate>)
@@ -745,7 +970,7 @@ namespace whirl
     >
     constexpr void next_if(I& ins, const P& pred)
     {
-        if (pred(ins))
+        if (pred.is(ins))
             next(ins);
     }
 
@@ -760,7 +985,7 @@ namespace whirl
     constexpr auto next_if(I& ins, const P& pred, const T& trans)
         -> std::optional<decltype(next(ins, trans))>
     {
-        if (pred(ins))
+        if (pred.is(ins))
             return next(ins, trans);
         else
             return std::nullopt;
@@ -774,7 +999,7 @@ namespace whirl
     >
     constexpr void next_if(I& ins, code_position& pos, const P& pred)
     {
-        if (pred(ins))
+        if (pred.is(ins))
            next(ins, pos);
     }
 
@@ -789,7 +1014,7 @@ namespace whirl
     constexpr std::optional<typename I::char_type> next_if(
         I& ins, code_position& pos, const P& pred, const T& trans)
     {
-        if (pred(ins))
+        if (pred.is(ins))
             return next(ins, pos, trans);
         else
             return std::nullopt;
@@ -808,7 +1033,7 @@ namespace whirl
     >
     constexpr void next_while(I& ins, const P& pred)
     {
-        while (pred(ins))
+        while (pred.is(ins))
             next(ins);
     }
 
@@ -824,7 +1049,7 @@ namespace whirl
     {
         decltype(concat(next(ins, trans), next(ins, trans))) result;
 
-        while (pred(ins))
+        while (pred.is(ins))
             result = concat(result, next(ins, trans));
 
         return result;
@@ -841,7 +1066,7 @@ namespace whirl
     >
     constexpr auto next_while(V init, I& ins, const P& pred, const T& trans)
     {
-        while (pred(ins))
+        while (pred.is(ins))
             init = concat(init, next(ins, trans));
 
         return init;
@@ -855,11 +1080,27 @@ namespace whirl
     >
     constexpr void next_while(I& ins, code_position& pos, const P& pred)
     {
-        while (pred.is(ins))
-            next(ins, pos);
+        if constexpr (is_contiguous_input_source_type_v<I>)
+        {
+            using traits = input_source_traits<I>;
+
+            // the run is consumed at once, and the position updated once
+            const auto first = traits::data(ins);
+            const auto count = detail::run_length(first, traits::size(ins), pred);
+
+            detail::advance_over(
+                pos, pred, std::basic_string_view<typename traits::char_type>{ first, count });
+            traits::advance(ins, count);
+        }
+        else
+        {
+            while (pred.is(ins))
+                next(ins, pos);
+        }
     }
 
     template <
+        typename V,
         typename I,
         typename P,
         typename T,
@@ -867,18 +1108,34 @@ namespace whirl
         typename = requires_t<is_bound_predicate<P>>,
         typename = requires_t<is_transformator<T>>
     >
-    constexpr auto next_while(I& ins, code_position& pos, const P& pred, const T& trans)
+    constexpr auto next_while(V init, I& ins, code_position& pos, P pred, T trans)
     {
-        decltype(concat(next(ins, trans), next(ins, trans))) result;
+        if constexpr (is_contiguous_input_source_type_v<I>)
+        {
+            using traits = input_source_traits<I>;
 
-        while (pred.is(ins))
-            result = concat(result, next(ins, pos, trans));
+            // The run is transformed before it's consumed at once and the position is updated
+            // once. If the transformator throws, the source is left at the start of the run.
+            const auto first = traits::data(ins);
+            const auto count = detail::run_length(first, traits::size(ins), pred);
 
-        return result;
+            for (std::size_t idx = 0; idx < count; ++idx)
+                init = concat(std::move(init), trans(first[idx]));
+
+            detail::advance_over(
+                pos, pred, std::basic_string_view<typename traits::char_type>{ first, count });
+            traits::advance(ins, count);
+        }
+        else
+        {
+            while (pred.is(ins))
+                init = concat(std::move(init), next(ins, pos, std::move(trans)));
+        }
+
+        return init;
     }
 
     template <
-        typename V,
         typename I,
         typename P,
         typename T,
@@ -886,12 +1143,11 @@ namespace whirl
         typename = requires_t<is_bound_predicate<P>>,
         typename = requires_t<is_transformator<T>>
     >
-    constexpr auto next_while(V init, I& ins, code_position& pos, P pred, T trans)
+    constexpr auto next_while(I& ins, code_position& pos, const P& pred, const T& trans)
     {
-        while (pred.is(ins))
-            init = concat(std::move(init), next(ins, pos, std::move(trans)));
+        decltype(concat(next(ins, trans), next(ins, trans))) result;
 
-        return init;
+        return next_while(std::move(result), ins, pos, pred, trans);
     }
 
 
@@ -958,7 +1214,7 @@ namespace whirl
         template <typename I>
         constexpr void operator()(I& ins, code_position& pos) const
         {
-            next_is(ins, this->pred, pos);
+            next_is(ins, pos, this->pred);
         }
 
         P pred;
@@ -0,0 +1,65 @@
+#ifndef __ALLOCATION_COUNTER_HPP__
+#define __ALLOCATION_COUNTER_HPP__
+
+
+// Counting of heap allocations. Linking allocation_counter.cpp replaces the global operator new
+// and operator delete by counting versions, which allows to assert that code doesn't allocate.
+//
+//   const allocations::counter counter;
+//   ...
+//   REQUIRE(counter.count() == 0);
+
+
+#include <cstddef>
+
+
+namespace allocations
+{
+
+    struct statistics
+    {
+        std::size_t count;
+        std::size_t bytes;
+    };
+
+    // the allocations of all threads since the program started
+    statistics total() noexcept;
+
+
+    // Counts the allocations of all threads during its lifetime.
+    class counter
+    {
+
+    public:
+
+        counter() noexcept
+            : m_start{ total() }
+        { }
+
+        statistics get() const noexcept
+        {
+            const auto now = total();
+
+            return statistics{ now.count - m_start.count, now.bytes - m_start.bytes };
+        }
+
+        std::size_t count() const noexcept
+        {
+            return this->get().count;
+        }
+
+        std::size_t bytes() const noexcept
+        {
+            return this->get().bytes;
+        }
+
+    private:
+
+        statistics m_start;
+
+    };
+
+}
+
+
+#endif /*__ALLOCATION_COUNTER_HPP__*/
@@ -1,6 +1,34 @@
 #define CATCH_CONFIG_MAIN
+#include <array>
+#include <numeric>
+#include <thread>
+
+#if defined(__linux__)
+    #include <sys/socket.h>
+#endif
+
 #include "catch.hpp"
 #include "whirl.hpp"
+#include "grammar.hpp"
+#include "regex.hpp"
+#include "lexer.hpp"
+#include "structural_index.hpp"
+#include "parallel.hpp"
+#include "mapped_file.hpp"
+#include "pipeline.hpp"
+#include "view.hpp"
+#include "resumable.hpp"
+#include "event_loop.hpp"
+#include "lexeme.hpp"
+#include "backtracking.hpp"
+#include "arena.hpp"
+#include "unicode.hpp"
+#include "delimiter.hpp"
+#include "quoted.hpp"
+#include "skip.hpp"
+#include "fixed_point.hpp"
+#include "iso8601.hpp"
+#include "allocation_counter.hpp"
 #include "sequential.hpp"
 
 
@@ -81,6 +109,23 @@ namespace whirl
     template <typename I, typename R>
     R dummy_transformator(I);
 
+    // Reads from a string view and from a stream, which have to agree on the value and on the
+    // characters consumed.
+    template <typename F>
+    auto read_both(const std::string& text, const F& read)
+    {
+        std::string_view view_ins = text;
+        std::istringstream stream_ins(text);
+
+        const auto view_value = read(view_ins);
+        const auto stream_value = read(stream_ins);
+
+        REQUIRE(view_value == stream_value);
+        REQUIRE(view_ins.size() == text.size() - static_cast<std::size_t>(stream_ins.tellg()));
+
+        return view_value;
+    }
+
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // compile-time checks
@@ -190,6 +235,129 @@ namespace whirl
     static_assert(!is_transformator_v<decltype(dummy_transformator<not_a_character, int>)>);
     static_assert(!is_transformator_v<decltype(dummy_transformator<int, void>)>);
 
+    // grammar analysis tests
+
+    // the grammar of the sequential example, see examples/sequential.hpp
+    constexpr auto sequential_data_entries = sequence(
+        repetition(space),
+        repetition(
+            sequence(
+                alternative(
+                    zero,
+                    sequence(option(negative_sign), non_zero_digit, repetition(digit))
+                ),
+                alternative(sequence(space, repetition(space)), end)
+            )
+        ),
+        end
+    );
+
+    static_assert(is_grammar_symbol_v<decltype(symbol(digit))>);
+    static_assert(is_grammar_symbol_v<decltype(sequence(digit, space))>);
+    static_assert(!is_grammar_symbol_v<decltype(digit)>);
+
+    static_assert(first_set(digit).contains('0'));
+    static_assert(first_set(digit).contains('9'));
+    static_assert(!first_set(digit).contains('a'));
+    static_assert(!first_set(digit).contains_end());
+    static_assert(first_set(end) == character_set::end());
+    static_assert(first_set(sequence(option(sign), digit)) == (first_set(sign) | first_set(digit)));
+    static_assert(first_set(alternative(zero, non_zero_digit)) == first_set(digit));
+
+    static_assert(!is_nullable(digit));
+    static_assert(is_nullable(repetition(digit)));
+    static_assert(is_nullable(sequence(option(sign), repetition(digit))));
+    static_assert(!is_nullable(sequence(option(sign), digit)));
+
+    static_assert(is_ll1(sequence(option(sign), digit, repetition(digit), end)));
+    static_assert(is_ll1(sequential_data_entries));
+
+    static_assert(
+        find_ll1_conflict(alternative(digit, zero)) == ll1_conflict::first_first);
+    static_assert(
+        find_ll1_conflict(sequence(repetition(digit), option(zero), end)) ==
+        ll1_conflict::first_follow);
+    static_assert(
+        find_ll1_conflict(sequence(repetition(digit), repetition(space), repetition(digit))) ==
+        ll1_conflict::first_follow);
+    static_assert(
+        find_ll1_conflict(alternative(option(digit), repetition(space))) ==
+        ll1_conflict::ambiguous_empty);
+    static_assert(
+        find_ll1_conflict(repetition(option(digit))) == ll1_conflict::empty_repetition);
+    static_assert(is_ll1(sequence(repetition(digit), option(sign)), character_set::of(space)));
+    static_assert(!is_ll1(sequence(repetition(digit), option(sign)), character_set::of(digit)));
+
+    // input source type trait tests
+
+    static_assert(is_input_source_type_v<std::string_view>);
+    static_assert(is_input_source_type_v<std::u32string_view>);
+    static_assert(is_contiguous_input_source_type_v<std::string_view>);
+    static_assert(!is_contiguous_input_source_type_v<std::istream>);
+    static_assert(is_input_source_type_v<std::istringstream>);
+    static_assert(is_input_source_type_v<std::wifstream>);
+    static_assert(is_input_source_type_v<pipelined_source<char>>);
+    static_assert(!is_contiguous_input_source_type_v<pipelined_source<char>>);
+    static_assert(is_bound_predicate_v<code_unit_class>);
+    static_assert(std::is_same_v<lexeme_t<std::string_view>, std::string_view>);
+    static_assert(std::is_same_v<lexeme_t<std::istringstream>, basic_lexeme<char>>);
+    static_assert(is_rewindable_input_source_type_v<std::string_view>);
+    static_assert(!is_rewindable_input_source_type_v<std::istringstream>);
+    static_assert(is_rewindable_input_source_type_v<replay_source<std::istringstream>>);
+    static_assert(is_input_source_type_v<fragment_source<char>>);
+    static_assert(is_input_source_type_v<utf8_source>);
+    static_assert(is_rewindable_input_source_type_v<utf8_source>);
+    static_assert(is_contiguous_input_source_type_v<validating_utf8_source>);
+    static_assert(is_rewindable_input_source_type_v<validating_utf8_source>);
+    static_assert(is_input_source_type_v<utf16_source>);
+    static_assert(is_rewindable_input_source_type_v<trusted_utf16_source>);
+    static_assert(!is_contiguous_input_source_type_v<fragment_source<char>>);
+
+    // regular expression tests
+
+    static_assert(regex("-?(0|[1-9][0-9]*)").matches("-120"));
+    static_assert(regex("-?(0|[1-9][0-9]*)").matches("0"));
+    static_assert(!regex("-?(0|[1-9][0-9]*)").matches("-"));
+    static_assert(!regex("-?(0|[1-9][0-9]*)").matches("01"));
+    static_assert(regex("\\d{4}-\\d{2}").matches("2020-12"));
+    static_assert(!regex("\\d{4}-\\d{2}").matches("202-12"));
+    static_assert(regex("a{2,3}b{1,}").matches("aaabb"));
+    static_assert(!regex("a{2,3}b{1,}").matches("aaaab"));
+    static_assert(!regex("a{2,3}b{1,}").matches("aa"));
+    static_assert(regex("[^x-z\\]]+\\.").matches("ab-c."));
+    static_assert(!regex("[^x-z\\]]+\\.").matches("a]."));
+    static_assert(regex("\\w+\\s*=\\S?").matches("key_1 \t="));
+    static_assert(regex("(ab|cd)*").matches(""));
+    static_assert(regex(".").matches("x") && !regex(".").matches("\n"));
+
+    // dead state, start state and one accepting state
+    static_assert(regex("a|a|a").state_count == 3);
+    static_assert(regex("(a|b)*a(a|b)(a|b)").state_count == 9);
+    static_assert(regex("[a-z]+").class_count == 2);
+
+    // lexer tests
+
+    static_assert([]() {
+        code_position pos{ 1, 1 };
+
+        pos.advance(std::string_view{ "ab\ncd\n\nef" });
+
+        return pos.row == 4 && pos.col == 2;
+    }());
+
+    static_assert(is_symbol_type_v<token_kind>);
+    static_assert(!is_character_type_v<token_kind>);
+    static_assert(!std::is_constructible_v<
+        token_source<decltype(lexer("a")), char>, decltype(lexer("a")), std::string_view>);
+    static_assert(is_bound_predicate_v<bound_is_predicate<token_kind>>);
+    static_assert(is_input_source_type_v<token_source<decltype(lexer("a")), char>>);
+
+    static_assert(lexer("if", "[a-z]+").match(std::string_view("if"), 0).kind == token_kind{ 0 });
+    static_assert(lexer("if", "[a-z]+").match(std::string_view("iffy"), 0).kind == token_kind{ 1 });
+    static_assert(lexer("[a-z]+", "if").match(std::string_view("if"), 0).kind == token_kind{ 0 });
+    static_assert(lexer("=", "==").match(std::string_view("==="), 0).length == 2);
+    static_assert(lexer("=").match(std::string_view("x"), 0).kind == invalid_token);
+
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // run-time checks
@@ -236,6 +404,16 @@ namespace whirl
             REQUIRE((is(U'b').is(ins    )) == false);
             REQUIRE((is(U'a').is(ins_eof)) == false);
         }
+
+        SECTION("look ahead comparisons")
+        {
+            input_stream_dummy<char> ins('a');
+            input_stream_dummy<char> ins_eof(std::char_traits<char>::eof());
+
+            REQUIRE(is(ins, 'a') == true );
+            REQUIRE(is(ins, 'b') == false);
+            REQUIRE(is(ins_eof, 'a') == false);
+        }
     }
 
     TEST_CASE( "testing is_not function overloads", "[is-not]" )
@@ -440,6 +618,2348 @@ namespace whirl
 
             REQUIRE(result.empty());
         }
+
+        SECTION("streaming")
+        {
+            whirl::code_position pos{ 1, 1 };
+
+            std::ifstream ifs("sequential.inp");
+
+            int count = 0;
+            int sum = 0;
+            int min = 0;
+
+            sequential::for_each_data_entry(ifs, pos, [&](int entry) {
+                ++count;
+                sum += entry;
+                min = std::min(min, entry);
+            });
+
+            REQUIRE(count == 15);
+            REQUIRE(sum == 15);
+            REQUIRE(min == -3);
+
+            std::istringstream iss("4 5 x 6");
+            std::ostringstream oss;
+
+            REQUIRE_THROWS_AS(
+                sequential::read_data_entries(iss, pos, std::ostream_iterator<int>(oss, ",")),
+                whirl::unexpected_input);
+            REQUIRE(oss.str() == "4,5,");
+
+            std::string_view view = "7 8";
+            int entries[2] = { };
+
+            REQUIRE(sequential::read_data_entries(view, pos, std::begin(entries)) ==
+                std::end(entries));
+            REQUIRE(entries[1] == 8);
+        }
+    }
+
+    TEST_CASE("testing grammar symbols", "[grammar]")
+    {
+        constexpr auto integer = sequence(option(negative_sign), digit, repetition(digit));
+        constexpr auto value = alternative(integer, sequence(is('('), integer, is(')')), is('x'));
+        constexpr auto values = sequence(value, repetition(sequence(is(','), value)), end);
+
+        SECTION("valid input")
+        {
+            std::istringstream iss("-12,(3),x,(-45)");
+            std::istream& ins = iss;
+            code_position pos{ 1, 1 };
+
+            REQUIRE_NOTHROW(values(ins, pos));
+            REQUIRE(pos.col == 16);
+        }
+
+        SECTION("invalid input")
+        {
+            std::istringstream iss1("12,,x");
+            std::istringstream iss2("12,(3");
+            std::istringstream iss3("y");
+
+            REQUIRE_THROWS_AS(values(static_cast<std::istream&>(iss1)), unexpected_input);
+            REQUIRE_THROWS_AS(values(static_cast<std::istream&>(iss2)), unexpected_input);
+            REQUIRE_THROWS_AS(values(static_cast<std::istream&>(iss3)), unexpected_input);
+        }
+
+        SECTION("alternative dispatch table")
+        {
+            REQUIRE(value.table[code_unit('7')] == 0);
+            REQUIRE(value.table[code_unit('-')] == 0);
+            REQUIRE(value.table[code_unit('(')] == 1);
+            REQUIRE(value.table[code_unit('x')] == 2);
+            REQUIRE(value.table[code_unit('y')] == value.no_alternative);
+            REQUIRE(value.table[character_set::end_index] == value.no_alternative);
+        }
+
+        SECTION("nullable alternative")
+        {
+            constexpr auto signed_digit = sequence(alternative(sign, repetition(space)), digit);
+
+            std::istringstream iss1("+1");
+            std::istringstream iss2("  1");
+            std::istringstream iss3("1");
+
+            REQUIRE_NOTHROW(signed_digit(static_cast<std::istream&>(iss1)));
+            REQUIRE_NOTHROW(signed_digit(static_cast<std::istream&>(iss2)));
+            REQUIRE_NOTHROW(signed_digit(static_cast<std::istream&>(iss3)));
+        }
+
+        SECTION("sequential grammar")
+        {
+            std::ifstream valid("sequential.inp");
+            std::ifstream invalid("sequential_invalid.inp");
+            std::istringstream empty;
+
+            REQUIRE(valid.is_open());
+            REQUIRE(invalid.is_open());
+
+            REQUIRE_NOTHROW(sequential_data_entries(static_cast<std::istream&>(valid)));
+            REQUIRE_THROWS_AS(
+                sequential_data_entries(static_cast<std::istream&>(invalid)), unexpected_input);
+            REQUIRE_NOTHROW(sequential_data_entries(static_cast<std::istream&>(empty)));
+        }
+    }
+
+    TEST_CASE("testing regular expressions", "[regex]")
+    {
+        constexpr auto number = regex("-?(0|[1-9][0-9]*)");
+
+        SECTION("contiguous input")
+        {
+            std::string_view input = "-42 7";
+
+            REQUIRE(number(input) == 3);
+            REQUIRE(input == " 7");
+            REQUIRE_THROWS_AS(number(input), unexpected_input);
+        }
+
+        SECTION("stream input")
+        {
+            std::istringstream iss("120\n-3x");
+            std::istream& ins = iss;
+            code_position pos{ 1, 1 };
+
+            REQUIRE(number(ins, pos) == 3);
+            REQUIRE(pos.col == 4);
+
+            next(ins, pos);
+
+            REQUIRE(number(ins, pos) == 2);
+            REQUIRE(pos.row == 2);
+            REQUIRE(pos.col == 2);
+            REQUIRE(ins.peek() == 'x');
+        }
+
+        SECTION("longest match")
+        {
+            constexpr auto prefix = regex("ab|abcd");
+
+            std::string_view input1 = "abd";
+            std::string_view input2 = "abce";
+            std::string_view input3 = "acd";
+
+            REQUIRE(prefix.starts(input1));
+            REQUIRE(prefix(input1) == 2);
+            REQUIRE(prefix(input2) == 2);
+            REQUIRE(input2 == "ce");
+            REQUIRE_THROWS_AS(prefix(input3), unexpected_input);
+
+            std::istringstream iss1("abce");
+            std::istringstream iss2("abce");
+            replay_source<std::istringstream> replay(iss1);
+            code_position pos{ 1, 1 };
+
+            REQUIRE(prefix(replay, pos) == 2);
+            REQUIRE(pos.col == 3);
+            REQUIRE(is(replay, 'c'));
+
+            // plain streams can't put back the characters read past the match
+            REQUIRE_THROWS_AS(prefix(static_cast<std::istream&>(iss2)), unexpected_input);
+        }
+
+        SECTION("invalid patterns")
+        {
+            REQUIRE_THROWS_AS(regex("(a"), invalid_regex);
+            REQUIRE_THROWS_AS(regex("a)"), invalid_regex);
+            REQUIRE_THROWS_AS(regex("[a"), invalid_regex);
+            REQUIRE_THROWS_AS(regex("*a"), invalid_regex);
+            REQUIRE_THROWS_AS(regex("a{2,1}"), invalid_regex);
+            REQUIRE_THROWS_AS(regex("a{200}"), regex_too_complex);
+        }
+    }
+
+    TEST_CASE("testing lexers", "[lexer]")
+    {
+        constexpr auto keyword    = token_kind{ 0 };
+        constexpr auto identifier = token_kind{ 1 };
+        constexpr auto assignment = token_kind{ 2 };
+        constexpr auto equality   = token_kind{ 3 };
+        constexpr auto number     = token_kind{ 4 };
+
+        constexpr auto tokens = lexer(
+            "if|else", "[a-z_]+", is('='), "==", "-?(0|[1-9][0-9]*)", skipped(space));
+
+        SECTION("tokenize")
+        {
+            std::vector<token> result;
+
+            tokens.tokenize(std::string_view("if iffy==-12\nelse"), [&result](const token& tok) {
+                result.push_back(tok);
+            });
+
+            REQUIRE(result.size() == 5);
+            REQUIRE(result[0].kind == keyword);
+            REQUIRE(result[1].kind == identifier);
+            REQUIRE(result[1].offset == 3);
+            REQUIRE(result[1].length == 4);
+            REQUIRE(result[2].kind == equality);
+            REQUIRE(result[3].kind == number);
+            REQUIRE(result[3].length == 3);
+            REQUIRE(result[4].kind == keyword);
+            REQUIRE(result[4].offset == 13);
+
+            REQUIRE_THROWS_AS(
+                tokens.tokenize(std::string_view("a ? b"), [](const token&) { }),
+                unexpected_input);
+        }
+
+        SECTION("token source")
+        {
+            token_source ins{ tokens, std::string_view(" x = 42 y == z ") };
+            code_position pos{ 1, 1 };
+
+            REQUIRE(is(ins, is(identifier)));
+            REQUIRE(ins.lexeme() == "x");
+
+            next_is(ins, pos, is(identifier));
+            next_is(ins, pos, is(assignment));
+
+            REQUIRE(ins.lexeme() == "42");
+            REQUIRE(ins.current().offset == 5);
+
+            next_is(ins, pos, is(number));
+            next_while(ins, pos, is_one_of(identifier, equality));
+            next_is(ins, pos, end);
+
+            REQUIRE(pos.col == 7);
+        }
+
+        SECTION("invalid lexemes")
+        {
+            token_source ins{ tokens, std::string_view("x ? y") };
+
+            next(ins);
+
+            REQUIRE(is(ins, is(invalid_token)));
+            REQUIRE(ins.current().offset == 2);
+            REQUIRE_THROWS_AS(next_is(ins, is(identifier)), unexpected_input);
+        }
+    }
+
+    TEST_CASE("testing structural indices", "[structural-index]")
+    {
+        SECTION("token boundaries")
+        {
+            const std::string_view text = "  ab c\n\tdef  g";
+            const auto index = structural_index(text, space);
+
+            REQUIRE(index.size() == 4);
+            REQUIRE(index.token(0) == "ab");
+            REQUIRE(index.offset(0) == 2);
+            REQUIRE(index.token(1) == "c");
+            REQUIRE(index.token(2) == "def");
+            REQUIRE(index.token(3) == "g");
+            REQUIRE(index.offset(3) + index.length(3) == text.size());
+
+            REQUIRE(structural_index(std::string_view(""), space).empty());
+            REQUIRE(structural_index(std::string_view(" \n "), space).empty());
+        }
+
+        SECTION("block boundaries")
+        {
+            // tokens spanning, starting and ending at the 64 character blocks
+            std::string text(63, ' ');
+
+            text += std::string(66, 'x') + ' ' + std::string(62, ' ') + "yy";
+
+            const auto index = structural_index(text, space);
+
+            REQUIRE(index.size() == 2);
+            REQUIRE(index.offset(0) == 63);
+            REQUIRE(index.length(0) == 66);
+            REQUIRE(index.offset(1) == 192);
+            REQUIRE(index.length(1) == 2);
+
+            std::string whole(128, 'x');
+
+            REQUIRE(structural_index(whole, space).size() == 1);
+            REQUIRE(structural_index(whole, space).length(0) == 128);
+        }
+
+        SECTION("lookup table classes")
+        {
+            const auto index = structural_index(std::string_view("1,2;3|x4"), is_none_of(
+                '0', '1', '2', '3', '4', '5', '6', '7', '8', '9'));
+
+            REQUIRE(std::vector<std::string_view>(index.begin(), index.end()) ==
+                std::vector<std::string_view>{ "1", "2", "3", "4" });
+        }
+
+        SECTION("sequential reader")
+        {
+            std::ifstream ifs("sequential.inp");
+            std::string text{ std::istreambuf_iterator<char>(ifs), { } };
+
+            code_position pos{ 1, 1 };
+            code_position indexed_pos{ 1, 1 };
+
+            std::istringstream iss(text);
+
+            REQUIRE(sequential::read_indexed_data_entries(text, indexed_pos) ==
+                sequential::read_data_entries(iss, pos));
+            REQUIRE(indexed_pos.row == pos.row);
+            REQUIRE(indexed_pos.col == pos.col);
+        }
+
+        SECTION("sequential reader errors")
+        {
+            code_position pos{ 1, 1 };
+            code_position indexed_pos{ 1, 1 };
+
+            std::istringstream iss("1 2\n 3x 4");
+
+            REQUIRE_THROWS_AS(sequential::read_data_entries(iss, pos), unexpected_input);
+            REQUIRE_THROWS_AS(
+                sequential::read_indexed_data_entries("1 2\n 3x 4", indexed_pos),
+                unexpected_input);
+            REQUIRE(indexed_pos.row == 2);
+            REQUIRE(indexed_pos.row == pos.row);
+            REQUIRE(indexed_pos.col == pos.col);
+
+            REQUIRE_THROWS_AS(
+                sequential::read_indexed_data_entries("1 - 2", pos), unexpected_input);
+            REQUIRE_THROWS_AS(
+                sequential::read_indexed_data_entries("1 -", pos), unexpected_input);
+            REQUIRE(sequential::read_indexed_data_entries("0 -10", pos) == std::vector{ 0, -10 });
+
+            indexed_pos = code_position{ 1, 1 };
+
+            REQUIRE_THROWS_AS(
+                sequential::read_indexed_data_entries("1\n-2147483649", indexed_pos),
+                unexpected_input);
+            REQUIRE(indexed_pos.row == 2);
+            REQUIRE(indexed_pos.col == 10);
+            REQUIRE(sequential::read_indexed_data_entries("-2147483648 2147483647", pos) ==
+                std::vector{ std::numeric_limits<int>::min(), std::numeric_limits<int>::max() });
+        }
+
+        SECTION("sequential reader adjacent entries")
+        {
+            code_position pos{ 1, 1 };
+            code_position indexed_pos{ 1, 1 };
+
+            std::istringstream iss("1 01 007-2\n-0-1");
+
+            const auto entries = sequential::read_data_entries(iss, pos);
+
+            REQUIRE(entries == std::vector{ 1, 0, 1, 0, 0, 7, -2, 0, -1 });
+            REQUIRE(sequential::read_indexed_data_entries("1 01 007-2\n-0-1", indexed_pos) ==
+                entries);
+            REQUIRE(indexed_pos.row == pos.row);
+            REQUIRE(indexed_pos.col == pos.col);
+        }
+    }
+
+    TEST_CASE("testing parallel parsing", "[parallel]")
+    {
+        thread_pool pool(4);
+
+        SECTION("thread pool")
+        {
+            auto answer = pool.submit([]() { return 42; });
+            auto failure = pool.submit([]() -> int { throw unexpected_input{}; });
+
+            REQUIRE(answer.get() == 42);
+            REQUIRE_THROWS_AS(failure.get(), unexpected_input);
+        }
+
+        SECTION("chunking")
+        {
+            const std::string_view text = "aaaa bb c ddddddd e";
+            const auto chunks = split_at_separators(text, space, 4);
+
+            REQUIRE(!chunks.empty());
+            REQUIRE(chunks.front() == "aaaa");
+
+            std::string joined;
+
+            for (const auto chunk : chunks)
+            {
+                REQUIRE(!chunk.empty());
+                REQUIRE((chunk.data() == text.data() || chunk.front() == ' '));
+
+                joined += chunk;
+            }
+
+            REQUIRE(joined == text);
+            REQUIRE(split_at_separators(std::string_view("abc"), space, 8).size() == 1);
+            REQUIRE(split_at_separators(std::string_view(""), space, 8).empty());
+        }
+
+        SECTION("ordered results")
+        {
+            std::string text;
+
+            for (int idx = -500; idx < 500; ++idx)
+                text += std::to_string(idx) + (idx % 10 ? " " : "\n");
+
+            code_position pos{ 1, 1 };
+            code_position parallel_pos{ 1, 1 };
+
+            std::string_view ins = text;
+
+            const auto expected = sequential::read_data_entries(ins, pos);
+
+            for (std::size_t chunk_count : { 1, 3, 64, 5000 })
+            {
+                parallel_pos = code_position{ 1, 1 };
+
+                REQUIRE(parse_parallel(text, parallel_pos, space,
+                    [](std::string_view& ins, code_position& pos) {
+                        return sequential::read_data_entries(ins, pos);
+                    }, pool, chunk_count) == expected);
+            }
+
+            REQUIRE(parallel_pos.row == pos.row);
+            REQUIRE(parallel_pos.col == pos.col);
+        }
+
+        SECTION("global error positions")
+        {
+            std::string text;
+
+            for (int idx = 0; idx < 1000; ++idx)
+                text += (idx == 700 ? "12x" : std::to_string(idx)) + (idx % 10 ? " " : "\n");
+
+            code_position pos{ 1, 1 };
+
+            try
+            {
+                sequential::read_data_entries_parallel(text, pos, pool);
+                FAIL("no parse error");
+            }
+            catch (const parallel_parse_error& error)
+            {
+                REQUIRE(error.offset == text.find("12x") + 2);
+                REQUIRE(error.position.row == pos.row);
+                REQUIRE(error.position.col == pos.col);
+            }
+
+            code_position sequential_pos{ 1, 1 };
+            std::istringstream iss(text);
+
+            REQUIRE_THROWS_AS(sequential::read_data_entries(iss, sequential_pos), unexpected_input);
+            REQUIRE(pos.row == sequential_pos.row);
+            REQUIRE(pos.col == sequential_pos.col);
+        }
+
+        SECTION("mapped files")
+        {
+            const mapped_file file("sequential.inp");
+            code_position pos{ 1, 1 };
+
+            std::ifstream ifs("sequential.inp");
+            std::string text{ std::istreambuf_iterator<char>(ifs), { } };
+
+            REQUIRE(file.view() == text);
+            REQUIRE(sequential::read_data_entries_parallel(file.view(), pos, pool).size() == 15);
+            REQUIRE_THROWS_AS(mapped_file("no such file"), std::system_error);
+        }
+    }
+
+    TEST_CASE("testing pipelined sources", "[pipeline]")
+    {
+        SECTION("spsc queue")
+        {
+            spsc_queue<int> queue(3);
+            int value = 0;
+
+            REQUIRE(queue.capacity() == 4);
+            REQUIRE(!queue.try_pop(value));
+
+            for (int idx = 0; idx < 4; ++idx)
+                REQUIRE(queue.try_push(idx));
+
+            REQUIRE(!queue.try_push(4));
+            REQUIRE(queue.try_pop(value));
+            REQUIRE(value == 0);
+            REQUIRE(queue.try_push(4));
+
+            for (int idx = 1; idx < 5; ++idx)
+            {
+                REQUIRE(queue.try_pop(value));
+                REQUIRE(value == idx);
+            }
+        }
+
+        SECTION("tokens straddling chunks")
+        {
+            std::string text;
+
+            for (int idx = -1000; idx < 1000; idx += 7)
+                text += std::to_string(idx) + (idx % 3 ? " " : "\n");
+
+            std::istringstream iss(text);
+            code_position pos{ 1, 1 };
+
+            const auto expected = sequential::read_data_entries(iss, pos);
+
+            for (std::size_t chunk_size : { 1, 3, 64, 4096 })
+            {
+                std::istringstream chunked(text);
+                pipelined_source<char> ins(chunked, chunk_size, 2);
+                code_position pipelined_pos{ 1, 1 };
+
+                REQUIRE(sequential::read_data_entries(ins, pipelined_pos) == expected);
+                REQUIRE(pipelined_pos.row == pos.row);
+                REQUIRE(pipelined_pos.col == pos.col);
+                REQUIRE(is(ins, end));
+            }
+        }
+
+        SECTION("producer errors")
+        {
+            int calls = 0;
+
+            pipelined_source<char> ins([&calls](char* buffer, std::size_t) -> std::size_t {
+                if (calls++ > 0)
+                    throw std::runtime_error{ "broken pipe" };
+
+                buffer[0] = '7';
+                return 1;
+            }, 16, 2);
+
+            REQUIRE(is(ins, '7'));
+            REQUIRE_THROWS_AS(next(ins), std::runtime_error);
+            REQUIRE(is(ins, end));
+
+            REQUIRE_THROWS_AS(pipelined_source<char>([](char*, std::size_t) -> std::size_t {
+                throw std::runtime_error{ "no such device" };
+            }), std::runtime_error);
+        }
+
+        SECTION("early destruction")
+        {
+            // the producer blocks on the exhausted chunk pool until the source is destroyed
+            pipelined_source<char> ins([](char* buffer, std::size_t capacity) {
+                std::fill_n(buffer, capacity, ' ');
+                return capacity;
+            }, 8, 2);
+
+            REQUIRE(is(ins, space));
+        }
+    }
+
+    TEST_CASE("testing batch parsing", "[batch]")
+    {
+        work_stealing_pool pool(4);
+
+        SECTION("work stealing")
+        {
+            // every task waits for its subtasks, which only works if waiting workers run them
+            std::function<int(int)> count = [&](int depth) {
+                if (depth == 0)
+                    return 1;
+
+                auto lhs = pool.submit([&count, depth]() { return count(depth - 1); });
+                auto rhs = pool.submit([&count, depth]() { return count(depth - 1); });
+
+                pool.wait(lhs);
+                pool.wait(rhs);
+
+                return lhs.get() + rhs.get();
+            };
+
+            auto result = pool.submit([&count]() { return count(8); });
+
+            pool.wait(result);
+
+            REQUIRE(result.get() == 256);
+        }
+
+        SECTION("nested parallel parsing")
+        {
+            std::string text;
+
+            for (int idx = 0; idx < 1000; ++idx)
+                text += std::to_string(idx) + ' ';
+
+            auto result = pool.submit([&]() {
+                code_position pos{ 1, 1 };
+
+                return sequential::read_data_entries_parallel(text, pos, pool).size();
+            });
+
+            REQUIRE(result.get() == 1000);
+        }
+
+        SECTION("error isolation")
+        {
+            const std::vector<std::string> paths = {
+                "sequential.inp", "no such file", "sequential_invalid.inp", "sequential.inp"
+            };
+
+            for (auto order : { sequential::delivery::ordered, sequential::delivery::unordered })
+            {
+                std::vector<sequential::file_result> results;
+
+                sequential::read_data_files(paths, pool, [&](sequential::file_result&& result) {
+                    results.push_back(std::move(result));
+                }, order);
+
+                REQUIRE(results.size() == paths.size());
+
+                if (order == sequential::delivery::ordered)
+                {
+                    for (std::size_t idx = 0; idx < results.size(); ++idx)
+                        REQUIRE(results[idx].index == idx);
+                }
+
+                std::sort(results.begin(), results.end(), [](const auto& lhs, const auto& rhs) {
+                    return lhs.index < rhs.index;
+                });
+
+                REQUIRE(!results[0].error);
+                REQUIRE(results[0].entries.size() == 15);
+                REQUIRE_THROWS_AS(std::rethrow_exception(results[1].error), std::system_error);
+                REQUIRE_THROWS_AS(std::rethrow_exception(results[2].error), unexpected_input);
+                REQUIRE(results[2].position.row == 1);
+                REQUIRE(results[2].position.col == 10);
+                REQUIRE(results[3].entries == results[0].entries);
+            }
+        }
     }
 
-}
\ No newline at end of file
+    TEST_CASE("testing parse views", "[view]")
+    {
+        SECTION("range-based for")
+        {
+            std::ifstream ifs("sequential.inp");
+            code_position pos{ 1, 1 };
+
+            std::vector<int> result;
+
+            for (const auto entry : parse_view(ifs, pos, sequential::read_data_entry))
+                result.push_back(entry);
+
+            std::ifstream expected("sequential.inp");
+            code_position expected_pos{ 1, 1 };
+
+            REQUIRE(result == sequential::read_data_entries(expected, expected_pos));
+            REQUIRE(pos.row == expected_pos.row);
+            REQUIRE(pos.col == expected_pos.col);
+        }
+
+        SECTION("bound consumers")
+        {
+            std::string_view ins = " 12\t7  301 ";
+
+            auto entries = parse_view(ins, next_while(digit, as_digit<int>));
+
+            REQUIRE(std::accumulate(entries.begin(), entries.end(), 0,
+                [](int sum, const auto& numtok) { return sum + numtok.value(); }) == 320);
+            REQUIRE(ins.empty());
+        }
+
+        SECTION("position free parsers")
+        {
+            std::string_view ins = " 12\n7  301";
+            code_position pos{ 1, 1 };
+
+            const auto read_word = [](std::string_view& word_ins) {
+                const auto word = word_ins.substr(0, word_ins.find_first_of(" \n"));
+
+                word_ins.remove_prefix(word.size());
+
+                return word;
+            };
+
+            std::vector<std::string_view> result;
+
+            for (const auto word : parse_view(ins, pos, read_word))
+                result.push_back(word);
+
+            REQUIRE(result == std::vector<std::string_view>{ "12", "7", "301" });
+            REQUIRE(pos.row == 2);
+            REQUIRE(pos.col == 6);
+        }
+
+        SECTION("early termination")
+        {
+            std::istringstream iss("1 2 3 4 oops");
+            std::istream& ins = iss;
+            code_position pos{ 1, 1 };
+            int first[3] = { };
+
+            auto entries = parse_view(ins, pos, sequential::read_data_entry);
+
+            std::copy_n(entries.begin(), 3, std::begin(first));
+
+            REQUIRE(first[2] == 3);
+            REQUIRE(pos.col == 6);
+
+            auto it = entries.begin();
+
+            REQUIRE(*it++ == 4);
+            REQUIRE_THROWS_AS(++it, unexpected_input);
+        }
+
+        SECTION("separators")
+        {
+            std::string_view ins = "1,2,,3";
+
+            auto entries = parse_view(ins, next_while(digit, as_digit<int>), is(','));
+
+            REQUIRE(std::distance(entries.begin(), entries.end()) == 3);
+
+            std::string_view unseparated = "1 2x";
+
+            auto invalid = parse_view(unseparated, next_while(digit, as_digit<int>));
+            auto it = invalid.begin();
+
+            REQUIRE_THROWS_AS(++++it, unexpected_input);
+        }
+    }
+
+    TEST_CASE("testing resumable parsing", "[resumable]")
+    {
+        std::string text;
+
+        for (int idx = -300; idx < 300; idx += 13)
+            text += std::to_string(idx * 37) + (idx % 4 ? "  " : "\n");
+
+        std::istringstream iss(text);
+        code_position expected_pos{ 1, 1 };
+
+        const auto expected = sequential::read_data_entries(iss, expected_pos);
+
+        SECTION("fragments of any size")
+        {
+            for (std::size_t size : { 1, 2, 3, 5, 8, 1000 })
+            {
+                resumable_parser parser{ sequential::read_data_entry };
+                std::vector<int> result;
+                const auto emit = [&result](int entry) { result.push_back(entry); };
+
+                for (std::size_t offset = 0; offset < text.size(); offset += size)
+                {
+                    parser.feed(std::string_view(text).substr(offset, size), emit);
+
+                    // only the incomplete entry is kept
+                    REQUIRE(parser.carried() <= 6);
+                }
+
+                parser.finish(emit);
+
+                REQUIRE(result == expected);
+                REQUIRE(parser.position().row == expected_pos.row);
+                REQUIRE(parser.position().col == expected_pos.col);
+                REQUIRE(parser.carried() == 0);
+            }
+        }
+
+        SECTION("entries spanning many fragments")
+        {
+            std::size_t attempts = 0;
+
+            resumable_parser parser{ [&attempts](auto& ins, code_position& pos) {
+                ++attempts;
+
+                return next_while(ins, pos, digit, as_digit<int>).value();
+            } };
+
+            std::vector<int> result;
+            const auto emit = [&result](int entry) { result.push_back(entry); };
+
+            parser.feed(" 1", emit);
+
+            for (int idx = 0; idx < 8; ++idx)
+                parser.feed("2", emit);
+
+            REQUIRE(parser.carried() == 9);
+
+            parser.feed("3 4", emit);
+            parser.finish(emit);
+
+            REQUIRE(result == std::vector{ 1222222223, 4 });
+
+            // the long entry is parsed once at the start and once it's complete
+            REQUIRE(attempts == 4);
+        }
+
+        SECTION("entries ending with the input")
+        {
+            resumable_parser parser{ sequential::read_data_entry };
+            std::vector<int> result;
+            const auto emit = [&result](int entry) { result.push_back(entry); };
+
+            parser.feed("12 -", emit);
+            parser.feed("4", emit);
+
+            REQUIRE(result == std::vector{ 12 });
+            REQUIRE(parser.carried() == 2);
+
+            parser.finish(emit);
+
+            REQUIRE(result == std::vector{ 12, -4 });
+        }
+
+        SECTION("errors")
+        {
+            resumable_parser parser{ sequential::read_data_entry };
+            const auto emit = [](int) { };
+
+            parser.feed("1 2", emit);
+            parser.feed("3\n4", emit);
+
+            REQUIRE_THROWS_AS(parser.feed("x 5", emit), unexpected_input);
+            REQUIRE(parser.position().row == 2);
+
+            resumable_parser incomplete{ sequential::read_data_entry };
+
+            incomplete.feed("7 -", emit);
+
+            REQUIRE_THROWS_AS(incomplete.finish(emit), unexpected_input);
+        }
+    }
+
+#if defined(WHIRL_HAS_EPOLL)
+
+    TEST_CASE("testing event loops", "[event-loop]")
+    {
+        constexpr std::size_t connection_count = 16;
+
+        std::string text;
+
+        for (int idx = 0; idx < 500; ++idx)
+            text += std::to_string(idx * 7 - 1000) + (idx % 10 ? " " : "\n");
+
+        // every connection gets the same text except the last one, which gets an error
+        const std::string bad_text = "1 2\n3 4x 5";
+
+        std::vector<int> sockets;
+        event_loop loop(256);
+
+        std::vector<std::vector<int>> results(connection_count);
+        std::vector<std::exception_ptr> errors(connection_count);
+        std::vector<code_position> positions(connection_count);
+        std::size_t done_count = 0;
+
+        for (std::size_t idx = 0; idx < connection_count; ++idx)
+        {
+            int pair[2];
+
+            REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair) == 0);
+
+            sockets.push_back(pair[1]);
+
+            loop.watch(
+                pair[0],
+                resumable_parser{ sequential::read_data_entry },
+                [&results, idx](int entry) { results[idx].push_back(entry); },
+                [&, idx](const auto& parser, std::exception_ptr error) {
+                    errors[idx] = error;
+                    positions[idx] = parser.position();
+                    ++done_count;
+                });
+        }
+
+        REQUIRE(loop.size() == connection_count);
+
+        // stands in for remote peers sending small, interleaved fragments
+        std::thread producer([&]() {
+            for (std::size_t offset = 0; offset < text.size(); offset += 7)
+            {
+                for (std::size_t idx = 0; idx < connection_count; ++idx)
+                {
+                    const auto& data = idx + 1 < connection_count ? text : bad_text;
+
+                    if (offset < data.size())
+                    {
+                        const auto count = std::min<std::size_t>(7, data.size() - offset);
+
+                        ::send(sockets[idx], data.data() + offset, count, MSG_NOSIGNAL);
+                    }
+                }
+            }
+
+            for (const auto fd : sockets)
+                ::close(fd);
+        });
+
+        loop.run();
+        producer.join();
+
+        std::istringstream iss(text);
+        code_position expected_pos{ 1, 1 };
+
+        const auto expected = sequential::read_data_entries(iss, expected_pos);
+
+        REQUIRE(done_count == connection_count);
+        REQUIRE(loop.size() == 0);
+
+        for (std::size_t idx = 0; idx + 1 < connection_count; ++idx)
+        {
+            REQUIRE(!errors[idx]);
+            REQUIRE(results[idx] == expected);
+            REQUIRE(positions[idx].row == expected_pos.row);
+            REQUIRE(positions[idx].col == expected_pos.col);
+        }
+
+        REQUIRE(results.back() == std::vector{ 1, 2, 3 });
+        REQUIRE_THROWS_AS(std::rethrow_exception(errors.back()), unexpected_input);
+        REQUIRE(positions.back().row == 2);
+
+        // regular files can't be watched, they are closed nevertheless
+        const auto file = ::open("sequential.inp", O_RDONLY);
+
+        REQUIRE(file >= 0);
+        REQUIRE_THROWS_AS(
+            loop.watch(file, resumable_parser{ sequential::read_data_entry }, [](int) { },
+                [](const auto&, std::exception_ptr) { }),
+            std::system_error);
+        REQUIRE(::fcntl(file, F_GETFD) < 0);
+
+        // a throwing done callback leaves no connection behind
+        int pair[2];
+
+        REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair) == 0);
+
+        loop.watch(pair[0], resumable_parser{ sequential::read_data_entry }, [](int) { },
+            [](const auto&, std::exception_ptr) { throw std::runtime_error{ "done" }; });
+
+        ::send(pair[1], "1 2x ", 5, MSG_NOSIGNAL);
+
+        REQUIRE_THROWS_AS(loop.run_once(-1), std::runtime_error);
+        REQUIRE(loop.size() == 0);
+
+        ::close(pair[1]);
+    }
+
+#endif
+
+    TEST_CASE("testing lexemes", "[lexeme]")
+    {
+        const auto name_char = is_none_of(' ', '\n', ',');
+        const auto separator = is_one_of(' ', '\n', ',');
+        const code_unit_class name_class{ name_char };
+
+        std::string text = "alpha,beta gamma\n";
+
+        text += std::string(100, 'x') + "," + std::string(64, 'y') + "\nz";
+
+        const std::vector<std::string> expected = {
+            "alpha", "beta", "gamma", std::string(100, 'x'), std::string(64, 'y'), "z"
+        };
+
+        SECTION("contiguous sources")
+        {
+            std::string_view ins = text;
+            code_position pos{ 1, 1 };
+            std::vector<std::string> result;
+
+            while (!is(ins, end))
+            {
+                const std::string_view lexeme = next_while_view(ins, pos, name_char);
+
+                // the lexeme refers to the source
+                REQUIRE(lexeme.data() >= text.data());
+                REQUIRE(lexeme.data() < text.data() + text.size());
+
+                result.emplace_back(lexeme);
+                next_while(ins, pos, separator);
+            }
+
+            REQUIRE(result == expected);
+            REQUIRE(pos.row == 3);
+            REQUIRE(pos.col == 1);
+        }
+
+        SECTION("code unit classes")
+        {
+            for (std::size_t offset = 0; offset < 70; ++offset)
+            {
+                const std::string padded = std::string(offset, 'a') + text;
+
+                std::string_view ins = padded;
+                std::string_view slow_ins = padded;
+
+                while (!is(ins, end))
+                {
+                    const auto lexeme = next_while_view(ins, name_class);
+
+                    REQUIRE(lexeme == next_while_view(slow_ins, name_char));
+                    REQUIRE(ins.size() == slow_ins.size());
+
+                    next_while(ins, separator);
+                    next_while(slow_ins, separator);
+                }
+            }
+
+            std::string_view ins = "abc";
+
+            REQUIRE(next_while_view(ins, name_class) == "abc");
+            REQUIRE(ins.empty());
+            REQUIRE(next_while_view(ins, name_class).empty());
+        }
+
+        SECTION("streams")
+        {
+            std::istringstream ins(text);
+            code_position pos{ 1, 1 };
+            std::vector<std::string> result;
+
+            while (!is(ins, end))
+            {
+                const auto lexeme = next_while_view(ins, pos, name_char);
+
+                result.emplace_back(lexeme.begin(), lexeme.end());
+                next_while(ins, pos, separator);
+            }
+
+            REQUIRE(result == expected);
+            REQUIRE(pos.row == 3);
+            REQUIRE(pos.col == 1);
+        }
+
+        SECTION("bound consumers")
+        {
+            constexpr auto read_name = next_while_view(is_none_of(' ', '\n', ','));
+
+            std::string_view ins = text;
+            std::istringstream iss(text);
+            code_position pos{ 1, 1 };
+
+            REQUIRE(read_name(ins) == "alpha");
+            REQUIRE(read_name(iss, pos).view() == "alpha");
+            REQUIRE(pos.col == 6);
+        }
+    }
+
+    TEST_CASE("testing backtracking", "[backtracking]")
+    {
+        // a time like 12:30 as minutes
+        const auto read_time = [](auto& ins, code_position& pos) {
+            const auto hours = sequential::read_data_entry(ins, pos);
+
+            next_is(ins, pos, is(':'));
+
+            return hours * 60 + sequential::read_data_entry(ins, pos);
+        };
+
+        const auto read_value = [&read_time](auto& ins, code_position& pos) {
+            if (const auto minutes = attempt(ins, pos, read_time))
+                return *minutes;
+
+            return sequential::read_data_entry(ins, pos);
+        };
+
+        const std::string text = "12:30 7 0:15\n-3";
+        const std::vector<int> expected = { 750, 7, 15, -3 };
+
+        const auto read_all = [&read_value](auto& ins, code_position& pos) {
+            std::vector<int> result;
+
+            for (next_while(ins, pos, space); !is(ins, end); next_while(ins, pos, space))
+                result.push_back(read_value(ins, pos));
+
+            return result;
+        };
+
+        SECTION("string views")
+        {
+            std::string_view ins = text;
+            code_position pos{ 1, 1 };
+
+            REQUIRE(read_all(ins, pos) == expected);
+            REQUIRE(pos.row == 2);
+            REQUIRE(pos.col == 2);
+        }
+
+        SECTION("replay sources")
+        {
+            std::istringstream iss(text);
+            replay_source ins(iss, 4);
+            code_position pos{ 1, 1 };
+
+            REQUIRE(read_all(ins, pos) == expected);
+            REQUIRE(pos.row == 2);
+            REQUIRE(pos.col == 2);
+        }
+
+        SECTION("void consumers and bound attempts")
+        {
+            std::string_view ins = "abd";
+            code_position pos{ 1, 1 };
+
+            const auto read_abc = [](auto& ins, code_position& pos) {
+                next_is(ins, pos, is('a'));
+                next_is(ins, pos, is('b'));
+                next_is(ins, pos, is('c'));
+            };
+
+            REQUIRE(!attempt(ins, pos, read_abc));
+            REQUIRE(ins == "abd");
+            REQUIRE(pos.col == 1);
+
+            REQUIRE(attempt(next_is(is('a')))(ins, pos));
+            REQUIRE(ins == "bd");
+            REQUIRE(pos.col == 2);
+        }
+
+        SECTION("bounded history")
+        {
+            std::istringstream iss("abcdefgh");
+            replay_source ins(iss, 4);
+
+            const auto mark = ins.mark();
+
+            next(ins);
+            next(ins);
+            ins.rewind(mark);
+
+            REQUIRE(next(ins, as_is) == 'a');
+
+            for (int idx = 0; idx < 4; ++idx)
+                next(ins);
+
+            REQUIRE_THROWS_AS(ins.rewind(mark), std::length_error);
+            REQUIRE(next(ins, as_is) == 'f');
+        }
+    }
+
+    TEST_CASE("testing arenas", "[arena]")
+    {
+        // counts the allocations passed to the default resource
+        struct counting_resource : std::pmr::memory_resource
+        {
+            void* do_allocate(std::size_t bytes, std::size_t alignment) override
+            {
+                ++allocations;
+                return std::pmr::get_default_resource()->allocate(bytes, alignment);
+            }
+
+            void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override
+            {
+                ++deallocations;
+                std::pmr::get_default_resource()->deallocate(ptr, bytes, alignment);
+            }
+
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+            {
+                return this == &other;
+            }
+
+            std::size_t allocations = 0;
+            std::size_t deallocations = 0;
+        };
+
+        std::string text;
+
+        for (int idx = 0; idx < 2000; ++idx)
+            text += std::to_string(idx - 1000) + (idx % 10 ? " " : "\n");
+
+        SECTION("repeated parses")
+        {
+            counting_resource upstream;
+
+            {
+                arena arena(256, &upstream);
+                std::size_t first_allocations = 0;
+
+                for (int run = 0; run < 3; ++run)
+                {
+                    std::string_view ins = text;
+                    code_position pos{ 1, 1 };
+
+                    const auto values = collect(
+                        parse_view(ins, pos, sequential::read_data_entry), arena);
+
+                    REQUIRE(values.size() == 2000);
+                    REQUIRE(values.front() == -1000);
+                    REQUIRE(values.back() == 999);
+                    REQUIRE(values.get_allocator().resource() == &arena);
+
+                    if (run == 0)
+                        first_allocations = upstream.allocations;
+
+                    // the blocks of the first parse are reused
+                    REQUIRE(upstream.allocations == first_allocations);
+
+                    arena.reset();
+                }
+
+                REQUIRE(upstream.deallocations == 0);
+            }
+
+            REQUIRE(upstream.deallocations == upstream.allocations);
+        }
+
+        SECTION("objects")
+        {
+            struct node
+            {
+                using allocator_type = std::pmr::polymorphic_allocator<int>;
+
+                node(int value, const allocator_type& alloc)
+                    : value{ value }
+                    , children{ alloc }
+                { }
+
+                int value;
+                arena_vector<node*> children;
+            };
+
+            arena arena(64);
+
+            const auto root = arena.make<node>(1);
+
+            for (int idx = 0; idx < 100; ++idx)
+                root->children.push_back(arena.make<node>(idx));
+
+            REQUIRE(root->children.get_allocator().resource() == &arena);
+            REQUIRE(root->children[99]->value == 99);
+
+            const auto aligned = arena.make<std::max_align_t>();
+
+            REQUIRE(reinterpret_cast<std::uintptr_t>(aligned) % alignof(std::max_align_t) == 0);
+
+            arena.release();
+
+            REQUIRE(arena.capacity() == 0);
+        }
+    }
+
+    TEST_CASE("testing allocations", "[allocation]")
+    {
+        constexpr std::size_t entry_count = 1000;
+
+        std::string text;
+
+        for (std::size_t idx = 0; idx < entry_count; ++idx)
+            text += std::to_string(int(idx) * 3 - 1500) + (idx % 8 ? " " : "\n");
+
+        std::istringstream iss(text);
+        std::array<int, entry_count> storage{ };
+
+        SECTION("counters")
+        {
+            const allocations::counter counter;
+
+            const std::vector<int> values(100);
+
+            REQUIRE(counter.count() == 1);
+            REQUIRE(counter.bytes() == 100 * sizeof(int));
+        }
+
+        SECTION("new handlers")
+        {
+            static int handler_calls = 0;
+
+            // too large to succeed, hence the handler has to give up
+            volatile auto size = std::numeric_limits<std::size_t>::max() / 2;
+
+            handler_calls = 0;
+
+            std::set_new_handler([]() {
+                if (++handler_calls == 2)
+                    std::set_new_handler(nullptr);
+            });
+
+            REQUIRE_THROWS_AS(::operator new(size), std::bad_alloc);
+            REQUIRE(handler_calls == 2);
+            REQUIRE(::operator new(size, std::nothrow) == nullptr);
+        }
+
+        SECTION("primitives")
+        {
+            std::string_view ins = text;
+            code_position pos{ 1, 1 };
+            std::size_t digit_count = 0;
+            std::size_t sign_count = 0;
+
+            const allocations::counter counter;
+
+            for (next_while(ins, pos, space); !is(ins, end); next_while(ins, pos, space))
+            {
+                if (is(ins, negative_sign))
+                {
+                    next(ins, pos);
+                    ++sign_count;
+                }
+
+                digit_count += next_while_view(ins, pos, digit).size();
+            }
+
+            REQUIRE(counter.count() == 0);
+            REQUIRE(sign_count == 500);
+            REQUIRE(digit_count > entry_count);
+        }
+
+        SECTION("bound consumers")
+        {
+            std::string_view ins = text;
+            code_position pos{ 1, 1 };
+            std::size_t count = 0;
+
+            const allocations::counter counter;
+
+            for (next_while(ins, pos, space); !is(ins, end); next_while(ins, pos, space))
+                storage[count++] = sequential::read_data_entry(ins, pos);
+
+            REQUIRE(counter.count() == 0);
+            REQUIRE(count == entry_count);
+            REQUIRE(storage.back() == 1497);
+        }
+
+        SECTION("sequential readers")
+        {
+            std::string_view ins = text;
+            code_position pos{ 1, 1 };
+            code_position stream_pos{ 1, 1 };
+            long long sum = 0;
+
+            const allocations::counter counter;
+
+            const auto last = sequential::read_data_entries(ins, pos, storage.begin());
+
+            sequential::for_each_data_entry(iss, stream_pos, [&sum](int value) { sum += value; });
+
+            REQUIRE(counter.count() == 0);
+            REQUIRE(last == storage.end());
+            REQUIRE(sum == std::accumulate(storage.begin(), storage.end(), 0ll));
+            REQUIRE(stream_pos.row == pos.row);
+            REQUIRE(stream_pos.col == pos.col);
+        }
+    }
+
+    TEST_CASE("testing UTF-8 sources", "[utf8]")
+    {
+        const auto decode_all = [](std::string_view text) {
+            utf8_source ins(text);
+            std::u32string result;
+
+            while (!is(ins, end))
+                result += next(ins, as_is);
+
+            return result;
+        };
+
+        const auto error_offset = [](std::string_view text) -> std::size_t {
+            try
+            {
+                utf8_source ins(text);
+
+                while (!is(ins, end))
+                    next(ins);
+            }
+            catch (const invalid_encoding& error)
+            {
+                return error.offset;
+            }
+
+            return text.size() + 1;
+        };
+
+        SECTION("decoding")
+        {
+            REQUIRE(decode_all("") == U"");
+            REQUIRE(decode_all("a\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80z")
+                == U"a\u00E9\u20AC\U0001F600z");
+            REQUIRE(decode_all("\xC2\x80\xDF\xBF\xE0\xA0\x80\xEF\xBF\xBF\xF4\x8F\xBF\xBF")
+                == U"\u0080\u07FF\u0800\uFFFF\U0010FFFF");
+
+            // ASCII runs longer than the SSE2 and the scan blocks, mixed with multi-byte sequences
+            std::string text;
+            std::u32string expected;
+
+            for (int idx = 0; idx < 50; ++idx)
+            {
+                text += std::string(idx * 11, 'a' + idx % 26) + "\xC3\xA9";
+                expected += std::u32string(idx * 11, U'a' + idx % 26) + U"\u00E9";
+            }
+
+            REQUIRE(decode_all(text) == expected);
+        }
+
+        SECTION("code positions")
+        {
+            utf8_source ins("\xC3\xA9t\xC3\xA9\n\xE2\x82\xAC 1");
+            code_position pos{ 1, 1 };
+
+            next_while(ins, pos, is_not(U'\n'));
+
+            REQUIRE(pos.col == 4);
+            REQUIRE(ins.offset() == 5);
+
+            next(ins, pos);
+            next_while(ins, pos, is_not(U'1'));
+
+            REQUIRE(pos.row == 2);
+            REQUIRE(pos.col == 2);
+        }
+
+        SECTION("validation")
+        {
+            REQUIRE(error_offset("ab\x80") == 2);          // stray continuation
+            REQUIRE(error_offset("ab\xC0\x80") == 2);      // overlong
+            REQUIRE(error_offset("\xE0\x9F\xBF") == 0);    // overlong
+            REQUIRE(error_offset("a\xED\xA0\x80") == 1);   // surrogate
+            REQUIRE(error_offset("\xF4\x90\x80\x80") == 0); // beyond U+10FFFF
+            REQUIRE(error_offset("\xF5\x80\x80\x80") == 0);
+            REQUIRE(error_offset("abc\xE2\x82") == 3);      // truncated
+            REQUIRE(error_offset("\xE2\x82z") == 0);
+
+            // the input is validated as far as it is read only
+            utf8_source ins("12 \xFF");
+            code_position pos{ 1, 1 };
+
+            REQUIRE(sequential::read_data_entry(ins, pos) == 12);
+            REQUIRE_THROWS_AS(next_while(ins, space), invalid_encoding);
+
+            // the malformed sequence isn't skipped
+            REQUIRE(ins.offset() == 3);
+            REQUIRE_THROWS_AS(next(ins), invalid_encoding);
+        }
+
+        SECTION("sequential data")
+        {
+            std::ifstream ifs("sequential.inp");
+            const std::string text{ std::istreambuf_iterator<char>(ifs), { } };
+
+            std::string_view view_ins = text;
+            code_position view_pos{ 1, 1 };
+
+            utf8_source ins(text);
+            code_position pos{ 1, 1 };
+
+            REQUIRE(sequential::read_data_entries(ins, pos) ==
+                sequential::read_data_entries(view_ins, view_pos));
+            REQUIRE(pos.row == view_pos.row);
+            REQUIRE(pos.col == view_pos.col);
+        }
+
+        SECTION("char predicates")
+        {
+            // characters beyond ASCII compare by their unsigned values
+            utf8_source ins("\xC3\xA9!");
+            std::u32string_view u32_ins = U"\u00E9!";
+
+            REQUIRE(is(ins, '\xE9'));
+            REQUIRE(is(u32_ins, '\xE9'));
+            REQUIRE(is(u32_ins, is_one_of('!', '\xE9')));
+            REQUIRE_FALSE(is(u32_ins, is_not('\xE9')));
+            REQUIRE_FALSE(is(u32_ins, is_none_of('!', '\xE9')));
+        }
+    }
+
+    TEST_CASE("testing UTF-8 validation", "[utf8-validation]")
+    {
+        const auto error_offset = [](std::string_view text) -> std::size_t {
+            try
+            {
+                validate_utf8(text);
+            }
+            catch (const invalid_encoding& error)
+            {
+                return error.offset;
+            }
+
+            return text.size() + 1;
+        };
+
+        const auto transcoding_error_offset = [](std::string_view text) -> std::size_t {
+            try
+            {
+                to_utf32(text);
+            }
+            catch (const invalid_encoding& error)
+            {
+                return error.offset;
+            }
+
+            return text.size() + 1;
+        };
+
+        // ASCII runs longer than the SSE2 blocks, mixed with multi-byte sequences
+        std::string text;
+        std::u32string expected;
+
+        for (int idx = 0; idx < 50; ++idx)
+        {
+            text += std::string(idx * 11, 'a' + idx % 26) + "\xE2\x82\xAC\xF0\x9F\x98\x80 ";
+            expected += std::u32string(idx * 11, U'a' + idx % 26) + U"\u20AC\U0001F600 ";
+        }
+
+        SECTION("whole buffers")
+        {
+            REQUIRE(to_utf32("") == U"");
+            REQUIRE(to_utf32(text) == expected);
+            REQUIRE_NOTHROW(validate_utf8(text));
+
+            for (const auto& [invalid, offset] : std::vector<std::pair<std::string, std::size_t>>{
+                { "ab\x80", 2 }, { "ab\xC0\x80", 2 }, { "a\xED\xA0\x80", 1 },
+                { "\xF4\x90\x80\x80", 0 }, { "abc\xE2\x82", 3 }, { text + "\xFF", text.size() }
+            })
+            {
+                REQUIRE(error_offset(invalid) == offset);
+                REQUIRE(transcoding_error_offset(invalid) == offset);
+            }
+        }
+
+        SECTION("validating sources")
+        {
+            const auto word_char = is_not(' ');
+            const code_unit_class word_class{ word_char };
+
+            validating_utf8_source ins(text);
+            std::size_t count = 0;
+
+            while (!is(ins, end))
+            {
+                REQUIRE(!next_while_view(ins, word_class).empty());
+                next(ins);
+                ++count;
+            }
+
+            REQUIRE(count == 50);
+
+            // reported once the malformed sequence is within the block following the position
+            const auto invalid = std::string(100, 'a') + " " + std::string(200, 'b') + "\xC0\x80";
+
+            validating_utf8_source invalid_ins(invalid);
+
+            REQUIRE(next_while_view(invalid_ins, word_class).size() == 100);
+            next(invalid_ins);
+
+            try
+            {
+                next_while_view(invalid_ins, word_class);
+                FAIL();
+            }
+            catch (const invalid_encoding& error)
+            {
+                REQUIRE(error.offset == 301);
+            }
+        }
+    }
+
+    TEST_CASE("testing UTF-16 sources", "[utf16]")
+    {
+        const auto decode_all = [](std::u16string_view text) {
+            utf16_source ins(text);
+            std::u32string result;
+
+            while (!is(ins, end))
+                result += next(ins, as_is);
+
+            return result;
+        };
+
+        const auto error_offset = [](std::u16string_view text) -> std::size_t {
+            try
+            {
+                utf16_source ins(text);
+
+                while (!is(ins, end))
+                    next(ins);
+            }
+            catch (const invalid_encoding& error)
+            {
+                return error.offset;
+            }
+
+            return text.size() + 1;
+        };
+
+        SECTION("decoding")
+        {
+            REQUIRE(decode_all(u"") == U"");
+            REQUIRE(decode_all(u"a\u00E9\uFFFF\U0001F600\U0010FFFFz")
+                == U"a\u00E9\uFFFF\U0001F600\U0010FFFFz");
+
+            // runs longer than the SSE2 and the scan blocks, mixed with surrogate pairs
+            std::u16string text;
+            std::u32string expected;
+
+            for (int idx = 0; idx < 50; ++idx)
+            {
+                text += std::u16string(idx * 11, u'\u00E0' + idx % 26) + u"\U0001F600";
+                expected += std::u32string(idx * 11, U'\u00E0' + idx % 26) + U"\U0001F600";
+            }
+
+            REQUIRE(decode_all(text) == expected);
+        }
+
+        SECTION("char predicates")
+        {
+            // the char predicates of the sequential readers apply to the decoded characters
+            utf16_source ins(u"\u00E9 12 -3");
+            trusted_utf16_source trusted_ins(u"\u00E9 12 -3");
+
+            REQUIRE(is(ins, '\xE9'));
+            REQUIRE(is(trusted_ins, is_one_of('\xE9')));
+
+            code_position pos{ 1, 1 };
+            code_position trusted_pos{ 1, 1 };
+
+            next(ins, pos);
+            next(trusted_ins, trusted_pos);
+
+            REQUIRE(sequential::read_data_entries(ins, pos) == std::vector<int>{ 12, -3 });
+            REQUIRE(sequential::read_data_entries(trusted_ins, trusted_pos)
+                == std::vector<int>{ 12, -3 });
+            REQUIRE(pos.col == 8);
+            REQUIRE(trusted_pos.col == 8);
+        }
+
+        SECTION("code positions")
+        {
+            utf16_source ins(u"\U0001F600t\U0001F600\n\u20AC 1");
+            code_position pos{ 1, 1 };
+
+            next_while(ins, pos, is_not(U'\n'));
+
+            REQUIRE(pos.col == 4);
+            REQUIRE(ins.offset() == 5);
+
+            next(ins, pos);
+            next_while(ins, pos, is_not(U'1'));
+
+            REQUIRE(pos.row == 2);
+            REQUIRE(pos.col == 2);
+        }
+
+        SECTION("validation")
+        {
+            const char16_t high = 0xD83D;
+            const char16_t low = 0xDE00;
+
+            REQUIRE(error_offset(std::u16string{ u'a', low, u'b' }) == 1);
+            REQUIRE(error_offset(std::u16string{ u'a', u'b', high }) == 2);
+            REQUIRE(error_offset(std::u16string{ high, u'a' }) == 0);
+            REQUIRE(error_offset(std::u16string{ high, high, low }) == 0);
+            REQUIRE(error_offset(std::u16string{ high, low, low }) == 2);
+
+            // trusted input passes lone surrogates on
+            const std::u16string text{ u'a', low, high };
+            trusted_utf16_source ins(text);
+
+            REQUIRE(next(ins, as_is) == U'a');
+            REQUIRE(next(ins, as_is) == low);
+            REQUIRE(next(ins, as_is) == high);
+            REQUIRE(is(ins, end));
+        }
+    }
+
+    TEST_CASE("testing code positions", "[code-position]")
+    {
+        const auto columns = [](auto text, column_unit unit) {
+            code_position pos{ 1, 1, unit };
+
+            for (const auto chr : text)
+                pos.update(chr);
+
+            code_position bulk_pos{ 1, 1, unit };
+
+            bulk_pos.advance(text);
+
+            REQUIRE(bulk_pos.row == pos.row);
+            REQUIRE(bulk_pos.col == pos.col);
+
+            return pos.col;
+        };
+
+        SECTION("column units")
+        {
+            // e with a combining acute accent, a thumbs up with a skin tone and a euro sign
+            const std::string_view utf8 =
+                "e\xCC\x81\xF0\x9F\x91\x8D\xF0\x9F\x8F\xBD\xE2\x82\xAC";
+            const std::u16string_view utf16 = u"e\u0301\U0001F44D\U0001F3FD\u20AC";
+            const std::u32string_view utf32 = U"e\u0301\U0001F44D\U0001F3FD\u20AC";
+
+            REQUIRE(columns(utf8, column_unit::code_units) == 15);
+            REQUIRE(columns(utf8, column_unit::code_points) == 6);
+            REQUIRE(columns(utf8, column_unit::graphemes) == 4);
+
+            REQUIRE(columns(utf16, column_unit::code_units) == 8);
+            REQUIRE(columns(utf16, column_unit::code_points) == 6);
+            REQUIRE(columns(utf16, column_unit::graphemes) == 4);
+
+            REQUIRE(columns(utf32, column_unit::code_units) == 6);
+            REQUIRE(columns(utf32, column_unit::code_points) == 6);
+            REQUIRE(columns(utf32, column_unit::graphemes) == 4);
+
+            // a combining mark split across runs
+            code_position pos{ 1, 1, column_unit::graphemes };
+
+            pos.advance(std::string_view{ "e\xCC" });
+            pos.advance(std::string_view{ "\x81x" });
+
+            REQUIRE(pos.col == 3);
+        }
+
+        SECTION("bulk updates")
+        {
+            const std::string_view lines = "ab\ncd\n\n\xC3\xA9""f";
+
+            REQUIRE(columns(std::string_view{ "" }, column_unit::code_units) == 1);
+            REQUIRE(columns(lines, column_unit::code_units) == 3);
+            REQUIRE(columns(lines, column_unit::code_points) == 2);
+
+            code_position pos{ 1, 1 };
+
+            pos.advance(std::string_view{ "ab\ncd\n\nef" });
+
+            REQUIRE(pos.row == 4);
+            REQUIRE(pos.col == 2);
+        }
+
+        SECTION("bulk consumers")
+        {
+            // more newlines than the byte counters of a block hold before they are summed up
+            std::string text;
+
+            for (int idx = 0; idx < 5000; ++idx)
+                text += idx % 3 == 0 ? "\n\n" : "ab\n";
+
+            text += "cde;";
+
+            std::istringstream stream_ins(text);
+            code_position stream_pos{ 1, 1 };
+
+            next_while(stream_ins, stream_pos, is_not(';'));
+
+            std::string_view ins = text;
+            code_position pos{ 1, 1 };
+
+            next_while(ins, pos, is_not(';'));
+
+            REQUIRE(pos.row == stream_pos.row);
+            REQUIRE(pos.col == stream_pos.col);
+            REQUIRE(pos.col == 3);
+            REQUIRE(ins == ";");
+
+            std::string_view view_ins = text;
+            code_position view_pos{ 1, 1 };
+
+            next_while_view(view_ins, view_pos, is_not(';'));
+
+            REQUIRE(view_pos.row == stream_pos.row);
+            REQUIRE(view_pos.col == stream_pos.col);
+
+            std::string_view class_ins = text;
+            code_position class_pos{ 1, 1 };
+
+            next_while(class_ins, class_pos, code_unit_class{ is_not(';') });
+
+            REQUIRE(class_pos.row == stream_pos.row);
+            REQUIRE(class_pos.col == stream_pos.col);
+            REQUIRE(class_ins == ";");
+        }
+
+        SECTION("transforming bulk consumers")
+        {
+            std::istringstream stream_ins("12345x");
+            code_position stream_pos{ 2, 3 };
+
+            const auto stream_number = next_while(stream_ins, stream_pos, digit, as_digit<int>);
+
+            std::string_view ins = "12345x";
+            code_position pos{ 2, 3 };
+
+            const auto number = next_while(ins, pos, digit, as_digit<int>);
+
+            REQUIRE(number.value() == 12345);
+            REQUIRE(number.value() == stream_number.value());
+            REQUIRE(pos.row == stream_pos.row);
+            REQUIRE(pos.col == stream_pos.col);
+            REQUIRE(pos.col == 8);
+            REQUIRE(ins == "x");
+
+            std::string_view next_ins = "678 ";
+
+            const auto next_number = next_while(
+                next(next_ins, pos, as_digit<int>), next_ins, pos, digit, as_digit<int>);
+
+            REQUIRE(next_number.value() == 678);
+            REQUIRE(pos.col == 11);
+        }
+
+        SECTION("64 bit counters")
+        {
+            code_position pos{ 0xFFFFFFFF, 0xFFFFFFFF };
+
+            pos.update('a');
+            pos.advance(std::string_view{ "bc" });
+
+            REQUIRE(pos.col == 0x100000002);
+
+            pos.update('\n');
+
+            REQUIRE(pos.row == 0x100000000);
+        }
+    }
+
+    TEST_CASE("testing delimiters", "[delimiter]")
+    {
+        using namespace std::literals;
+
+        // fields longer than the SSE2 blocks
+        const auto long_field = std::string(40, 'x');
+        const auto text = "alpha,beta;gamma\n" + long_field + ",\r\n" + long_field + "\r;\r\nz";
+
+        SECTION("single delimiters")
+        {
+            std::string_view ins = text;
+            std::istringstream stream_ins(text);
+
+            for (const auto& expected : { "alpha"s, "beta;gamma\n" + long_field })
+            {
+                REQUIRE(std::string_view{ next_until(ins, ',') } == expected);
+                REQUIRE(std::string_view{ next_until(stream_ins, ',') } == expected);
+
+                next(ins);
+                next(stream_ins);
+            }
+
+            // the rest of the input without a delimiter
+            REQUIRE(next_until(ins, '#') == "\r\n" + long_field + "\r;\r\nz");
+            REQUIRE(is(ins, end));
+            REQUIRE(next_until(ins, '#').empty());
+        }
+
+        SECTION("several delimiters")
+        {
+            std::vector<std::string> fields;
+            std::vector<std::string> stream_fields;
+
+            std::string_view ins = text;
+            std::istringstream stream_ins(text);
+
+            for (;;)
+            {
+                fields.emplace_back(next_until_one_of(ins, ',', ';', '\n'));
+
+                if (is(ins, end))
+                    break;
+
+                next(ins);
+            }
+
+            for (;;)
+            {
+                stream_fields.emplace_back(next_until_one_of(stream_ins, ',', ';', '\n').view());
+
+                if (is(stream_ins, end))
+                    break;
+
+                next(stream_ins);
+            }
+
+            const std::vector<std::string> expected = {
+                "alpha", "beta", "gamma", long_field, "\r", long_field + "\r", "\r", "z"
+            };
+
+            REQUIRE(fields == expected);
+            REQUIRE(stream_fields == expected);
+        }
+
+        SECTION("delimiters of several characters")
+        {
+            std::string_view ins = text;
+
+            REQUIRE(next_until(ins, "\r\n"sv) == "alpha,beta;gamma\n" + long_field + ",");
+            REQUIRE(next_until(ins, "\r\n"sv).empty());
+
+            ins.remove_prefix(2);
+
+            // the carriage return before the semicolon isn't a delimiter
+            REQUIRE(next_until(ins, "\r\n"sv) == long_field + "\r;");
+
+            // candidates at every offset within and across the SSE2 blocks
+            for (std::size_t offset = 0; offset < 40; ++offset)
+            {
+                const auto padded =
+                    std::string(offset, 'a') + "ab-a-b-ab-abc" + std::string(20, 'c');
+                std::string_view padded_ins = padded;
+
+                REQUIRE(next_until(padded_ins, "ab-abc"sv).size() == offset + 7);
+                REQUIRE(next_until(padded_ins, "cccc-"sv).size() == 26);
+                REQUIRE(is(padded_ins, end));
+            }
+        }
+
+        SECTION("positions and bound consumers")
+        {
+            std::string_view ins = text;
+            code_position pos{ 1, 1 };
+
+            const auto field = next_until_one_of(',', ';');
+            const auto line = next_until("\r\n"sv);
+
+            REQUIRE(field(ins, pos) == "alpha");
+            next(ins, pos);
+            REQUIRE(next_until(ins, pos, ',') == "beta;gamma\n" + long_field);
+
+            REQUIRE(pos.row == 2);
+            REQUIRE(pos.col == 40);
+
+            REQUIRE(line(ins, pos) == ",");
+            ins.remove_prefix(2);
+            REQUIRE(next_until(ins, pos, '\n') == long_field + "\r;\r");
+
+            REQUIRE(pos.row == 2);
+            REQUIRE(pos.col == 84);
+        }
+    }
+
+    TEST_CASE("testing quoted strings", "[quoted]")
+    {
+        // escape sequences beyond the SSE2 blocks
+        const auto long_text = std::string(40, 'x');
+        const auto text = "\"plain\" \"" + long_text + "\\\"q\\\\\\n\" \"\"";
+
+        const std::vector<std::string> expected = { "plain", long_text + "\"q\\\n", "" };
+
+        SECTION("contiguous sources")
+        {
+            std::string_view ins = text;
+            std::string buffer;
+
+            const auto plain = read_quoted(ins, buffer);
+
+            // the string without escape sequences refers to the source
+            REQUIRE(plain == expected[0]);
+            REQUIRE(plain.data() == text.data() + 1);
+
+            next(ins);
+            REQUIRE(read_quoted(ins, buffer) == expected[1]);
+            REQUIRE(buffer == expected[1]);
+
+            next(ins);
+            REQUIRE(read_quoted(ins, buffer).empty());
+            REQUIRE(is(ins, end));
+        }
+
+        SECTION("stream sources")
+        {
+            std::istringstream ins(text);
+            code_position pos{ 1, 1 };
+            std::string buffer;
+
+            for (const auto& string : expected)
+            {
+                REQUIRE(read_quoted(ins, pos, buffer) == string);
+                next_while(ins, pos, space);
+            }
+
+            std::string_view view_ins = text;
+            code_position view_pos{ 1, 1 };
+
+            for (std::size_t idx = 0; idx < expected.size(); ++idx)
+            {
+                read_quoted(view_ins, view_pos, buffer);
+                next_while(view_ins, view_pos, space);
+            }
+
+            REQUIRE(view_pos.row == pos.row);
+            REQUIRE(view_pos.col == pos.col);
+        }
+
+        SECTION("quotes as escape characters")
+        {
+            const std::string csv = "'it''s',''''";
+
+            std::string_view ins = csv;
+            std::istringstream stream_ins(csv);
+            std::string buffer;
+
+            REQUIRE(read_quoted(ins, buffer, '\'', '\'') == "it's");
+            REQUIRE(read_quoted(stream_ins, buffer, '\'', '\'') == "it's");
+
+            next(ins);
+            next(stream_ins);
+
+            REQUIRE(read_quoted(ins, buffer, '\'', '\'') == "'");
+            REQUIRE(read_quoted(stream_ins, buffer, '\'', '\'') == "'");
+        }
+
+        SECTION("arena buffers and bound consumers")
+        {
+            arena arena;
+            arena_string buffer{ &arena };
+
+            const auto quoted = read_quoted(buffer);
+
+            std::string_view ins = text;
+            code_position pos{ 1, 1 };
+
+            REQUIRE(quoted(ins, pos) == expected[0]);
+            next(ins, pos);
+            REQUIRE(quoted(ins, pos) == expected[1]);
+            REQUIRE(pos.col == 58);
+        }
+
+        SECTION("errors")
+        {
+            std::string buffer;
+
+            for (const auto invalid : { "", "plain", "\"unterminated", "\"escape\\" })
+            {
+                std::string_view ins = invalid;
+                std::istringstream stream_ins(invalid);
+
+                REQUIRE_THROWS_AS(read_quoted(ins, buffer), unexpected_input);
+                REQUIRE_THROWS_AS(read_quoted(stream_ins, buffer), unexpected_input);
+            }
+        }
+    }
+
+
+    TEST_CASE("testing skippers", "[skip]")
+    {
+        const auto long_comment = std::string(100, '*');
+        // whitespace longer than the short runs and the scanned blocks
+        const auto text = std::string(100, ' ') + "# line comment\n\t/* block " + long_comment
+            + " */ /**/\n# last comment\n1 /* unterminated";
+
+        const auto skip_all = skip(space, "#", "/*", "*/");
+
+        SECTION("contiguous sources")
+        {
+            std::string_view ins = text;
+            code_position pos{ 1, 1 };
+
+            skip_all(ins, pos);
+
+            REQUIRE(ins.substr(0, 2) == "1 ");
+            REQUIRE(pos.row == 4);
+            REQUIRE(pos.col == 0);
+
+            // no whitespace or comment
+            skip_all(ins, pos);
+
+            REQUIRE(pos.col == 0);
+
+            next(ins, pos);
+
+            REQUIRE_THROWS_AS(skip_all(ins, pos), unexpected_input);
+            REQUIRE(is(ins, end));
+        }
+
+        SECTION("rewindable sources")
+        {
+            std::istringstream stream(text);
+            replay_source<std::istringstream> ins(stream);
+            code_position pos{ 1, 1 };
+
+            skip_all(ins, pos);
+
+            REQUIRE(next(ins, pos, as_is) == '1');
+            REQUIRE(pos.row == 4);
+            REQUIRE(pos.col == 1);
+
+            REQUIRE_THROWS_AS(skip_all(ins, pos), unexpected_input);
+        }
+
+        SECTION("stream sources")
+        {
+            const std::string shell_text = " # comment\n  # comment\n\nx";
+
+            std::istringstream ins(shell_text);
+            std::string_view view_ins = shell_text;
+            code_position pos{ 1, 1 };
+            code_position view_pos{ 1, 1 };
+
+            const auto skip_shell = skip(space, "#");
+
+            skip_shell(ins, pos);
+            skip_shell(view_ins, view_pos);
+
+            REQUIRE(is(ins, 'x'));
+            REQUIRE(view_ins == "x");
+            REQUIRE(pos.row == view_pos.row);
+            REQUIRE(pos.col == view_pos.col);
+
+            // comments of several characters need more look ahead than a stream provides
+            std::istringstream block_ins("/* comment */");
+
+            REQUIRE_THROWS_AS(skip_all(block_ins), std::logic_error);
+
+            // even if no such comment is next, before anything is consumed
+            std::istringstream blank_ins("  x");
+
+            REQUIRE_THROWS_AS(skip_all(blank_ins, pos), std::logic_error);
+            REQUIRE(is(blank_ins, ' '));
+        }
+
+        SECTION("predicates")
+        {
+            // newlines aren't skipped, but end line comments
+            const auto skip_blanks = skip(is_one_of(' ', '\t'), "//");
+
+            std::string_view ins = "  // comment\n  x";
+
+            skip_blanks(ins);
+
+            REQUIRE(ins == "\n  x");
+        }
+
+        SECTION("delimiters")
+        {
+            REQUIRE_THROWS_AS(skip(space, "#", "/*"), std::logic_error);
+            REQUIRE_THROWS_AS(skip(space, "#", "", "*/"), std::logic_error);
+            REQUIRE_NOTHROW(skip(space, "#", "", ""));
+        }
+
+        SECTION("character types")
+        {
+            const auto skip_wide = skip<char16_t>(space, u"#", u"/*", u"*/");
+
+            std::u16string_view ins = u"  # comment\n /* comment */ x";
+            code_position pos{ 1, 1 };
+
+            skip_wide(ins, pos);
+
+            REQUIRE(ins == u"x");
+            REQUIRE(pos.row == 2);
+            REQUIRE(pos.col == 15);
+        }
+    }
+
+
+    TEST_CASE("testing fixed point numbers", "[fixed-point]")
+    {
+        const auto hundredths = read_fixed_point<int, 100>();
+
+        SECTION("scaling")
+        {
+            REQUIRE(read_both("23.45 ", hundredths) == 2345);
+            REQUIRE(read_both("-23.45 ", hundredths) == -2345);
+            REQUIRE(read_both("+7 ", hundredths) == 700);
+            REQUIRE(read_both("0.5 ", hundredths) == 50);
+            REQUIRE(read_both("-0.05 ", hundredths) == -5);
+            REQUIRE(read_both("12345678901.25 ", read_fixed_point<long long, 100>()) ==
+                1234567890125);
+            REQUIRE(read_both("42.9 ", read_fixed_point<int, 1>()) == 42);
+            REQUIRE(read_both("0.000123456789 ", read_fixed_point<long long, 1000000000000>()) ==
+                123456789);
+        }
+
+        SECTION("rounding")
+        {
+            const auto rounded = read_fixed_point<int, 100, rounding::nearest>();
+
+            REQUIRE(read_both("23.456 ", hundredths) == 2345);
+            REQUIRE(read_both("23.456 ", rounded) == 2346);
+            REQUIRE(read_both("23.4549999999 ", rounded) == 2345);
+            REQUIRE(read_both("-23.455 ", rounded) == -2346);
+            REQUIRE(read_both("0.995 ", rounded) == 100);
+            REQUIRE(read_both("2.5 ", read_fixed_point<int, 1, rounding::nearest>()) == 3);
+        }
+
+        SECTION("overflow")
+        {
+            const auto int8_units = read_fixed_point<std::int8_t, 1>();
+
+            REQUIRE(read_both("127 ", int8_units) == 127);
+            REQUIRE(read_both("-128 ", int8_units) == -128);
+            REQUIRE(read_both("00000000000127 ", int8_units) == 127);
+
+            REQUIRE(read_both("9223372036854775807 ", read_fixed_point<std::int64_t, 1>()) ==
+                std::numeric_limits<std::int64_t>::max());
+            REQUIRE(read_both("-92233720368547758.08 ", read_fixed_point<std::int64_t, 100>()) ==
+                std::numeric_limits<std::int64_t>::min());
+
+            for (const std::string text : { "128", "-129", "127.5" })
+            {
+                std::string_view ins = text;
+                const auto read = [](auto& ins) {
+                    return read_fixed_point<std::int8_t, 1, rounding::nearest>(ins);
+                };
+
+                REQUIRE_THROWS_AS(read(ins), value_out_of_range);
+
+                std::istringstream stream_ins(text);
+
+                REQUIRE_THROWS_AS(read(stream_ins), value_out_of_range);
+            }
+
+            std::string_view ins = "21474836.48";
+
+            REQUIRE_THROWS_AS((read_fixed_point<int, 100>(ins)), value_out_of_range);
+
+            ins = "123456789012345678901234567890";
+
+            REQUIRE_THROWS_AS((read_fixed_point<std::uint64_t, 1>(ins)), value_out_of_range);
+        }
+
+        SECTION("malformed numbers")
+        {
+            std::string_view ins = "-x";
+
+            REQUIRE_THROWS_AS(hundredths(ins), unexpected_input);
+            REQUIRE(ins == "x");
+
+            ins = ".5";
+
+            REQUIRE_THROWS_AS(hundredths(ins), unexpected_input);
+            REQUIRE(ins == ".5");
+
+            ins = "5.x";
+
+            REQUIRE_THROWS_AS(hundredths(ins), unexpected_input);
+            REQUIRE(ins == "x");
+
+            // unsigned numbers have no minus sign
+            ins = "-5";
+
+            REQUIRE_THROWS_AS((read_fixed_point<unsigned, 100>(ins)), unexpected_input);
+            REQUIRE(ins == "-5");
+
+            std::istringstream stream_ins("5.");
+
+            REQUIRE_THROWS_AS(hundredths(stream_ins), unexpected_input);
+        }
+
+        SECTION("positions")
+        {
+            std::string_view ins = "12.5; -3.25";
+            std::istringstream stream_ins("12.5; -3.25");
+            code_position pos{ 1, 1 };
+            code_position stream_pos{ 1, 1 };
+
+            REQUIRE(hundredths(ins, pos) == 1250);
+            REQUIRE(hundredths(stream_ins, stream_pos) == 1250);
+            REQUIRE(pos.col == 5);
+            REQUIRE(stream_pos.col == 5);
+
+            next(ins, pos);
+            next(ins, pos);
+
+            REQUIRE(hundredths(ins, pos) == -325);
+            REQUIRE(pos.col == 12);
+            REQUIRE(ins.empty());
+        }
+    }
+
+
+    TEST_CASE("testing ISO 8601 timestamps", "[iso8601]")
+    {
+        using namespace std::chrono;
+
+        // the nanoseconds since 1970 of a timestamp followed by " end"
+        const auto read_time = [](const std::string& text) {
+            return read_both(text, [](auto& ins) {
+                const auto time = read_iso8601(ins);
+
+                REQUIRE(is(ins, ' '));
+
+                return time.time_since_epoch().count();
+            });
+        };
+
+        SECTION("layouts")
+        {
+            REQUIRE(read_time("1970-01-01T00:00:00 end") == 0);
+            REQUIRE(read_time("1970-01-01T00:00:00Z end") == 0);
+            REQUIRE(read_time("2024-02-29T12:34:56Z end") == 1709210096000000000);
+            REQUIRE(read_time("2024-02-29T12:34:56.789Z end") == 1709210096789000000);
+            REQUIRE(read_time("2024-02-29T12:34:56.123456789123 end") == 1709210096123456789);
+            REQUIRE(read_time("2024-02-29T14:34:56+02:00 end") == 1709210096000000000);
+            REQUIRE(read_time("2024-02-29T07:04:56.5-05:30 end") == 1709210096500000000);
+            REQUIRE(read_time("1969-12-31T23:59:59.9Z end") == -100000000);
+            REQUIRE(read_time("2000-03-01T00:00:00Z end") == 951868800000000000);
+
+            // the bounds of the time points
+            REQUIRE(read_time("1677-09-21T00:12:43.145224192Z end")
+                == std::numeric_limits<std::int64_t>::min());
+            REQUIRE(read_time("2262-04-11T23:47:16.854775807Z end")
+                == std::numeric_limits<std::int64_t>::max());
+        }
+
+        SECTION("invalid timestamps")
+        {
+            for (const std::string text : {
+                "2023-02-29T00:00:00", "1900-02-29T00:00:00", "2024-13-01T00:00:00",
+                "2024-04-31T00:00:00", "2024-01-00T00:00:00", "2024-01-01T24:00:00",
+                "2024-01-01T00:60:00", "2024-01-01T00:00:60", "2024-01-01T00:00:00+24:00" })
+            {
+                std::string_view ins = text;
+                std::istringstream stream_ins(text);
+
+                REQUIRE_THROWS_AS(read_iso8601(ins), unexpected_input);
+                REQUIRE_THROWS_AS(read_iso8601(stream_ins), unexpected_input);
+            }
+
+            std::string_view ins = "2024-01-01 00:00:00Z";
+
+            REQUIRE_THROWS_AS(read_iso8601(ins), unexpected_input);
+            REQUIRE(ins == " 00:00:00Z");
+
+            ins = "2024-01-01T00:00:0xZ";
+
+            REQUIRE_THROWS_AS(read_iso8601(ins), unexpected_input);
+            REQUIRE(ins == "xZ");
+
+            ins = "2024-01-01T00:00:00.Z";
+
+            REQUIRE_THROWS_AS(read_iso8601(ins), unexpected_input);
+            REQUIRE(ins == "Z");
+
+            // too short for converting the date and time at once
+            ins = "2024-1-01";
+
+            REQUIRE_THROWS_AS(read_iso8601(ins), unexpected_input);
+            REQUIRE(ins == "-01");
+
+            ins = "2300-01-01T00:00:00Z";
+
+            REQUIRE_THROWS_AS(read_iso8601(ins), value_out_of_range);
+
+            ins = "1677-09-21T00:12:43.145224191Z";
+
+            REQUIRE_THROWS_AS(read_iso8601(ins), value_out_of_range);
+
+            ins = "2262-04-11T23:47:16.854775808Z";
+
+            REQUIRE_THROWS_AS(read_iso8601(ins), value_out_of_range);
+        }
+
+        SECTION("positions")
+        {
+            const std::string text = "2024-02-29T12:34:56.25Z\n2024-03-01T00:00:00";
+
+            std::string_view ins = text;
+            std::istringstream stream_ins(text);
+            code_position pos{ 1, 1 };
+            code_position stream_pos{ 1, 1 };
+
+            const auto read = read_iso8601();
+
+            REQUIRE(read(ins, pos) == read(stream_ins, stream_pos));
+            REQUIRE(pos.col == 24);
+            REQUIRE(stream_pos.col == 24);
+
+            next(ins, pos);
+
+            REQUIRE(read(ins, pos).time_since_epoch() == hours{ 24 * 19783 });
+            REQUIRE(pos.row == 2);
+            REQUIRE(pos.col == 19);
+            REQUIRE(ins.empty());
+        }
+    }
+}